@@ -29,6 +29,17 @@ target_link_libraries(unit_tests gtest gtest_main ${PROJECT_NAME} pthread)
 enable_testing()
 add_test(UnitTests unit_tests)
 
+# The same tests against a copy of the library built with the other limb policy
+add_library(${PROJECT_NAME}_other_limbs ${SOURCE_FILES})
+target_link_libraries(${PROJECT_NAME}_other_limbs Threads::Threads)
+if(NOT BINARY_LIMBS)
+  target_compile_definitions(${PROJECT_NAME}_other_limbs PUBLIC BIGINT_BINARY_LIMBS)
+endif()
+
+add_executable(unit_tests_other_limbs ${TEST_FILES})
+target_link_libraries(unit_tests_other_limbs gtest gtest_main ${PROJECT_NAME}_other_limbs pthread)
+add_test(UnitTestsOtherLimbs unit_tests_other_limbs)
+
 SET(CMAKE_CXX_FLAGS "-g -O0 -fprofile-arcs -ftest-coverage")
 SET(CMAKE_C_FLAGS "-g -O0 -fprofile-arcs -ftest-coverage")
 
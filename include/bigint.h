@@ -6,20 +6,47 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstdint>
 #include <exception>
-#include <map>
+#include <memory_resource>
 #include <sstream>
 #include <string>
 #include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 #include "smallvector.h"
 
 namespace BigMath {
 
+// Radix of the limbs every Bigint is stored in, fixed for the whole library when it is built. Decimal limbs make
+// printing and the digit functions cheap; binary limbs hold 7% more bits each, carry with shifts rather than
+// divisions and make the bit operations linear, but convert to decimal on input and output. Define
+// BIGINT_BINARY_LIMBS for the library and for everything including this header to use binary limbs.
+struct DecimalLimbs {
+  using Limb = int32_t;
+  static constexpr uint64_t BASE = 1000000000;
+  static constexpr bool BINARY = false;
+};
+
+struct BinaryLimbs {
+  using Limb = uint32_t;
+  static constexpr uint64_t BASE = uint64_t{ 1 } << 32U;
+  static constexpr bool BINARY = true;
+};
+
+#ifdef BIGINT_BINARY_LIMBS
+using LimbPolicy = BinaryLimbs;
+#else
+using LimbPolicy = DecimalLimbs;
+#endif
+using Limb = LimbPolicy::Limb;
+
 class Bigint {
 private:
-  SmallVector<int32_t> number;// max size of vector uint32_t
-  mutable bool positive = true;
+  SmallVector<Limb> number;// little endian limbs of the magnitude
+  bool positive = true;
 
 public:
   // Constructors
@@ -31,16 +58,33 @@ public:
   Bigint(int64_t value);
   Bigint(std::string_view string);
 
-  // Adding
-  Bigint operator+(const Bigint &right) const;
+  // Allocator-extended constructors, copies and results keep the allocator of their source
+  using allocator_type = std::pmr::polymorphic_allocator<Limb>;
+
+  explicit Bigint(const allocator_type &allocator);
+  Bigint(int64_t value, const allocator_type &allocator);
+  Bigint(std::string_view string, const allocator_type &allocator);
+  Bigint(const Bigint &bigint, const allocator_type &allocator);
+  Bigint(Bigint &&bigint, const allocator_type &allocator);
+
+  // Adding, the rvalue overloads reuse the storage of a temporary operand
+  Bigint operator+(const Bigint &right) const &;
+  Bigint operator+(const Bigint &right) &&;
+  Bigint operator+(Bigint &&right) const &;
+  Bigint operator+(Bigint &&right) &&;
   Bigint &operator+=(const Bigint &right);
-  Bigint operator+(const int64_t &value) const;
+  Bigint operator+(const int64_t &value) const &;
+  Bigint operator+(const int64_t &value) &&;
   Bigint &operator+=(int64_t value);
 
-  // Subtraction
-  Bigint operator-(const Bigint &right) const;
+  // Subtraction, the rvalue overloads reuse the storage of a temporary operand
+  Bigint operator-(const Bigint &right) const &;
+  Bigint operator-(const Bigint &right) &&;
+  Bigint operator-(Bigint &&right) const &;
+  Bigint operator-(Bigint &&right) &&;
   Bigint &operator-=(const Bigint &right);
-  Bigint operator-(const int64_t &value) const;
+  Bigint operator-(const int64_t &value) const &;
+  Bigint operator-(const int64_t &value) &&;
   Bigint &operator-=(int64_t value);
 
   // Unary minus
@@ -49,15 +93,45 @@ public:
   // Multiplication
   Bigint operator*(const Bigint &right) const;
   Bigint &operator*=(const Bigint &right);
-  Bigint operator*(int64_t value) const;
+  Bigint operator*(int64_t value) const &;
+  Bigint operator*(int64_t value) &&;
   Bigint &operator*=(const int64_t &value);
 
+  // Fused multiply-add, the product is accumulated straight into this value's limbs
+  Bigint &addmul(const Bigint &left, const Bigint &right);// *this += left * right
+  Bigint &submul(const Bigint &left, const Bigint &right);// *this -= left * right
+  Bigint &addmul_1(const Bigint &left, int64_t value);// *this += left * value
+  Bigint &submul_1(const Bigint &left, int64_t value);// *this -= left * value
+
   // Division
-  Bigint operator/(Bigint right);
+  Bigint operator/(const Bigint &right) const;
   Bigint &operator/=(const Bigint &right);
 
   // Modulo
   [[nodiscard]] int64_t operator%(const int64_t &value) const;
+  Bigint operator%(const Bigint &right) const;
+  Bigint &operator%=(const Bigint &right);
+
+  // Quotient and remainder from a single division pass
+  friend std::pair<Bigint, Bigint> divmod(const Bigint &left, const Bigint &right);
+
+  // Product on up to threads threads, 0 for one per core. Small operands are multiplied on the calling thread.
+  friend Bigint multiply(const Bigint &left, const Bigint &right, size_t threads);
+
+  // Shifts, multiplying or dividing by 2^shift with >> rounding toward negative infinity
+  Bigint operator<<(uint64_t shift) const;
+  Bigint &operator<<=(uint64_t shift);
+  Bigint operator>>(uint64_t shift) const;
+  Bigint &operator>>=(uint64_t shift);
+
+  // Bitwise, negative numbers act as two's complement with infinitely many leading ones
+  Bigint operator&(const Bigint &right) const;
+  Bigint &operator&=(const Bigint &right);
+  Bigint operator|(const Bigint &right) const;
+  Bigint &operator|=(const Bigint &right);
+  Bigint operator^(const Bigint &right) const;
+  Bigint &operator^=(const Bigint &right);
+  Bigint operator~() const;
 
   // Comparison
   [[nodiscard]] bool operator<(const Bigint &other) const;
@@ -87,23 +161,58 @@ public:
   [[nodiscard]] int32_t digits() const;
   [[nodiscard]] bool is_even() const;
   [[nodiscard]] bool is_negative() const;
+  [[nodiscard]] allocator_type get_allocator() const;
+  [[nodiscard]] uint64_t bit_length() const;// bits of |this|, 0 for zero
+  [[nodiscard]] uint64_t count_trailing_zeros() const;// 0 for zero
+  [[nodiscard]] uint64_t popcount() const;// set bits of |this|
+  [[nodiscard]] bool test_bit(uint64_t index) const;// bit of the two's complement
   Bigint clone() const;
-  void flip_sign() const;
+  void flip_sign();
 
   Bigint &add_zeroes(uint32_t amount);
   Bigint &remove_trailing(uint32_t amount);
 
   // Power
-  Bigint &pow(const uint32_t &power);
+  Bigint &pow(uint64_t power);
+  Bigint &square();
 
   [[nodiscard]] int8_t compare(const Bigint &right) const;// 0 a == b, -1 a < b, 1 a > b
 private:
+  void add_magnitude(const Limb *right, size_t right_size);// |this| += right
+  void sub_magnitude(const Limb *right, size_t right_size);// |this| -= right, the sign flips when right is larger
+  void fused_multiply(const Limb *left, size_t left_size, const Limb *right, size_t right_size, bool product_positive);
+
   [[nodiscard]] constexpr static int32_t segment_length(int32_t segment);
-  [[nodiscard]] Bigint pow(const uint32_t &power, std::map<int32_t, Bigint> *lookup);
-  [[nodiscard]] static Bigint get_fragment(const Bigint &bigint, int32_t which);
+
+  friend class ModContext;
+  friend struct Euclid;
+  friend struct Roots;
+  friend struct Binary;
+  friend struct Decimal;
 };
 
 std::string to_string(const Bigint &bigint);
+std::pair<Bigint, Bigint> divmod(const Bigint &left, const Bigint &right);
+Bigint multiply(const Bigint &left, const Bigint &right, size_t threads);
+std::vector<int64_t> remainders(const Bigint &value, const std::vector<int64_t> &moduli);// value % moduli[i] for every i
+
+// Number theory, the results are non-negative except for the cofactors
+Bigint gcd(const Bigint &left, const Bigint &right);
+Bigint lcm(const Bigint &left, const Bigint &right);
+std::tuple<Bigint, Bigint, Bigint> extended_gcd(const Bigint &left, const Bigint &right);// {g, x, y}, left * x + right * y = g
+Bigint mod_inverse(const Bigint &value, const Bigint &modulus);// x in [0, modulus) with value * x % modulus == 1
+
+// Roots round toward zero, even roots of negative numbers throw
+Bigint isqrt(const Bigint &value);
+Bigint iroot(const Bigint &value, uint64_t k);
+bool is_perfect_square(const Bigint &value);
+bool is_perfect_power(const Bigint &value);// value == r^k for some integers r and k >= 2
+
+// Products as balanced trees, whose upper levels run on up to threads threads, 0 for one per core
+Bigint product(const std::vector<Bigint> &factors, size_t threads = 1);
+Bigint product_range(uint64_t low, uint64_t high, size_t threads = 1);// low * (low + 1) * ... * high, 1 when empty
+Bigint factorial(uint64_t n, size_t threads = 1);
+Bigint binomial(uint64_t n, uint64_t k, size_t threads = 1);// 0 when k > n
 
 }// namespace BigMath
 
@@ -0,0 +1,47 @@
+#pragma once
+
+#ifndef MODCONTEXT_H_
+#define MODCONTEXT_H_
+
+#include "bigint.h"
+
+namespace BigMath {
+
+// Arithmetic modulo one fixed positive modulus, with the reduction constants computed once up front.
+// Operands and results are residues in the context's own form, see to_residue and from_residue. A small modulus
+// coprime to the limb base uses Montgomery form with R = BASE^limbs, any other modulus uses Barrett reduction on
+// plain residues. Neither divides per operation.
+class ModContext {
+private:
+  Bigint mod;
+  Bigint r_squared;// R^2 mod m, Montgomery only
+  Bigint mu;// floor(R^2 / m), Barrett only
+  Bigint one;// 1 as a residue
+  size_t size = 0;// limbs in the modulus
+  uint32_t inverse = 0;// -m^-1 mod BASE, 0 when using Barrett
+
+public:
+  explicit ModContext(const Bigint &modulus);
+
+  [[nodiscard]] const Bigint &modulus() const;
+  [[nodiscard]] bool is_montgomery() const;
+
+  // Conversion between integers and residues, value may be negative or larger than the modulus
+  [[nodiscard]] Bigint to_residue(const Bigint &value) const;
+  [[nodiscard]] Bigint from_residue(const Bigint &residue) const;
+
+  // Operations on residues, the exponent is a non negative integer
+  [[nodiscard]] Bigint mulmod(const Bigint &left, const Bigint &right) const;
+  [[nodiscard]] Bigint sqrmod(const Bigint &residue) const;
+  [[nodiscard]] Bigint powmod(const Bigint &residue, const Bigint &exponent) const;
+
+private:
+  // Limbs of a residue without leading zeros, throws when the value is negative or not below the modulus.
+  [[nodiscard]] size_t residue_size(const Bigint &residue) const;
+  // Reduces product[0, 2 * size + 1), a value below m^2 with a zero top limb, into a residue.
+  [[nodiscard]] Bigint reduce(SmallVector<Limb> &product, const Bigint::allocator_type &allocator) const;
+};
+
+}// namespace BigMath
+
+#endif /* MODCONTEXT_H_ */
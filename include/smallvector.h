@@ -1,6 +1,10 @@
 #pragma once
 
+#include <algorithm>
+#include <cstring>
+#include <memory_resource>
 #include <stdexcept>
+#include <type_traits>
 
 namespace BigMath {
 
@@ -19,78 +23,64 @@ template<size_t T_size>
 }
 
 
-// FUNCTION TEMPLATE allocate_for_delete
-template<class T>
-T *allocate_for_delete(size_t Count) {
-  // allocates space for _Count copies of _Ty, which will be freed with scalar delete
-  if (Count == 0) {
-    return nullptr;
-  }
-
-  const size_t Bytes = get_size_of_n<sizeof(T)>(Count);
-#ifdef __cpp_aligned_new
-  constexpr bool Extended_alignment = alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__;
-  if constexpr (Extended_alignment) {
-    return static_cast<T *>(::operator new (Bytes, std::align_val_t{ alignof(T) }));
-  } else
-#endif// __cpp_aligned_new
-  {
-    return static_cast<T *>(::operator new(Bytes));
-  }
-}
-
-template<class T>
-class SmallVector {// store array with various indexing options
+// store array with various indexing options, the first N elements live inside the object
+template<class T, size_t N = 4>
+class SmallVector {
 public:
   SmallVector() = default;// construct empty ValArr
-  explicit SmallVector(size_t count) {
-    _size = 0;
-    _capacity = count;
-
+  explicit SmallVector(std::pmr::memory_resource *resource) noexcept : _resource(resource) {}
+  explicit SmallVector(size_t count, std::pmr::memory_resource *resource = std::pmr::get_default_resource()) : _resource(resource) {
     grow(count);
   }
-  SmallVector(const T &val, size_t count) {
+  SmallVector(const T &val, size_t count, std::pmr::memory_resource *resource = std::pmr::get_default_resource()) : _resource(resource) {
+    allocate(count);
+    for (size_t Idx = 0; Idx < count; ++Idx) {
+      _ptr[Idx] = val;
+    }
     _size = count;
-    _capacity = count;
-
-    grow(count, &val);
   }
-  SmallVector(const T *ptr, size_t count) {
+  SmallVector(const T *ptr, size_t count, std::pmr::memory_resource *resource = std::pmr::get_default_resource()) : _resource(resource) {
+    allocate(count);
+    relocate(_ptr, ptr, count);
     _size = count;
-    _capacity = count;
-
-    grow(count, ptr, 1);
-  }
-  SmallVector(const SmallVector &right) {
-    _size = right._size;
-    _capacity = right._size;
-
-    grow(right._capacity, right._ptr, 1);
   }
-  SmallVector(SmallVector &&right) noexcept {
-    init();
+  SmallVector(const SmallVector &right) : SmallVector(right, right._resource) {}// copies stay with the source's resource
+  SmallVector(const SmallVector &right, std::pmr::memory_resource *resource) : SmallVector(right._ptr, right._size, resource) {}
+  SmallVector(SmallVector &&right) noexcept : _resource(right._resource) {
     assign_rv(std::move(right));
   }
 
-  SmallVector &operator=(SmallVector &&right) noexcept {
+  // Unlike the move constructor, which shares right's resource, assigning and swapping copy the elements when they
+  // are inline or come from another resource, and that copy can allocate. Neither is noexcept for that reason.
+  SmallVector &operator=(SmallVector &&right) {
     assign_rv(std::move(right));
     return *this;
   }
 
   void assign_rv(SmallVector &&right) {
-    if (this != std::addressof(right)) {// clear this and steal from right
-      deallocate();
-      _ptr = right._ptr;
-      _size = right._size;
-      _capacity = right._capacity;
-      right.init();
+    if (this != std::addressof(right)) {
+      if (right.is_inline() || *_resource != *right._resource) {// inline or foreign elements cannot be stolen, copy them
+        if (_capacity < right._size) {
+          allocate(right._size);
+        }
+        relocate(_ptr, right._ptr, right._size);
+        _size = right._size;
+        right.deallocate();
+      } else {// clear this and steal from right
+        deallocate();
+        _ptr = right._ptr;
+        _size = right._size;
+        _capacity = right._capacity;
+        right.init();
+      }
     }
   }
 
-  void swap(SmallVector &right) noexcept {
+  void swap(SmallVector &right) {
     if (this != std::addressof(right)) {
-      std::swap(_ptr, right._ptr);
-      std::swap(_size, right._size);
+      SmallVector temp(std::move(right));
+      right.assign_rv(std::move(*this));
+      assign_rv(std::move(temp));
     }
   }
 
@@ -100,10 +90,11 @@ public:
 
   SmallVector &operator=(const SmallVector &right) {
     if (this != std::addressof(right)) {
+      if (_capacity < right._size) {
+        allocate(right._size);
+      }
+      relocate(_ptr, right._ptr, right._size);
       _size = right._size;
-      _capacity = right._size;
-
-      grow(right._capacity, right._ptr, 1);
     }
 
     return *this;
@@ -116,15 +107,7 @@ public:
   void resize(size_t newsize, T val) {// determine new length, filling with _Val elements
     if (newsize > _size) {
       if (newsize > _capacity) {
-        T *_temp = allocate_for_delete<T>(newsize);
-
-        for (size_t Idx = 0; Idx < _size; ++Idx) {
-          _temp[Idx] = _ptr[Idx];
-        }
-        delete _ptr;
-        _ptr = std::move(_temp);
-
-        _capacity = newsize;
+        reserve(std::max(newsize, _capacity * 2));
       }
       for (size_t Idx = _size; Idx < newsize; ++Idx) {
         _ptr[Idx] = val;
@@ -147,7 +130,7 @@ public:
 
   void push_back(T val) {
     if (_size == _capacity) {
-      reserve(_capacity <= 4 ? 8 : _capacity * 2);
+      reserve(_capacity * 2);
     }
     _ptr[_size++] = val;
   }
@@ -160,17 +143,28 @@ public:
 
   void reserve(size_t capacity) {
     if (_capacity < capacity) {
-      _capacity = capacity;
-      T *_temp = allocate_for_delete<T>(capacity);
+      T *_temp = allocate_heap(capacity);
 
-      for (size_t Idx = 0; Idx < _size; ++Idx) {
-        _temp[Idx] = _ptr[Idx];
-      }
-      delete _ptr;
+      relocate(_temp, _ptr, _size);
+      release();
       _ptr = _temp;
+      _capacity = capacity;
     }
   }
 
+  void shrink_to_fit() {// release unused heap capacity, moving back inline when the elements fit
+    if (is_inline() || _size == _capacity) {
+      return;
+    }
+
+    T *_temp = _size <= N ? _inline : allocate_heap(_size);
+
+    relocate(_temp, _ptr, _size);
+    release();
+    _ptr = _temp;
+    _capacity = _size <= N ? N : _size;
+  }
+
   void clear() {
     _size = 0;
   }
@@ -195,38 +189,69 @@ public:
     return &_ptr[0] + _size;
   }
 
+  [[nodiscard]] std::pmr::memory_resource *get_resource() const noexcept {
+    return _resource;
+  }
+
 private:
   void grow(size_t new_capacity) {// allocate space for _Count elements and fill with default values
-    delete _ptr;
-    _ptr = allocate_for_delete<T>(new_capacity);
+    allocate(new_capacity);
     for (size_t Idx = 0; Idx < new_capacity; ++Idx) {
       _ptr[Idx] = 0;
     }
   }
 
-  void grow(size_t new_capacity, const T *ptr, size_t inc) {
-    delete _ptr;
-    _ptr = allocate_for_delete<T>(new_capacity);
-    for (size_t Idx = 0; Idx < new_capacity; ++Idx, ptr += inc) {
-      _ptr[Idx] = *ptr;
+  static void relocate(T *dest, const T *src, size_t count) {// copy count elements between non overlapping buffers
+    if constexpr (std::is_trivially_copyable_v<T>) {
+      if (count != 0) {
+        std::memcpy(dest, src, count * sizeof(T));
+      }
+    } else {
+      for (size_t Idx = 0; Idx < count; ++Idx) {
+        dest[Idx] = src[Idx];
+      }
+    }
+  }
+
+  void allocate(size_t new_capacity) {// point _ptr at storage for new_capacity elements, contents are discarded
+    T *storage = new_capacity <= N ? _inline : allocate_heap(new_capacity);// a failed allocation leaves this intact
+
+    release();
+    _ptr = storage;
+    _capacity = new_capacity <= N ? N : new_capacity;
+  }
+
+  [[nodiscard]] bool is_inline() const noexcept {
+    return _ptr == _inline;
+  }
+
+  [[nodiscard]] T *allocate_heap(size_t count) {
+    return static_cast<T *>(_resource->allocate(get_size_of_n<sizeof(T)>(count), alignof(T)));
+  }
+
+  void release() noexcept {// free heap storage, leaves _ptr dangling
+    if (!is_inline()) {
+      _resource->deallocate(_ptr, _capacity * sizeof(T), alignof(T));
     }
   }
 
   void init() noexcept {
     _size = 0;
-    _capacity = 0;
-    _ptr = nullptr;
+    _capacity = N;
+    _ptr = _inline;
   }
 
   void deallocate() noexcept {
-    delete _ptr;
+    release();
 
     init();
   }
 
-  T *_ptr = nullptr;// current storage reserved for array
+  std::pmr::memory_resource *_resource = std::pmr::get_default_resource();// source of heap storage
+  T *_ptr = _inline;// current storage reserved for array
   size_t _size = 0;// current length of sequence
-  size_t _capacity = 0;// current capacity of sequence
+  size_t _capacity = N;// current capacity of sequence
+  T _inline[N] = {};// storage used while the sequence fits in N elements
 };
 
 }// namespace BigMath
@@ -1,242 +1,157 @@
 #include "bigint.h"
+#include "limbs.h"
+
+#include <vector>
 
 namespace BigMath {
 
 constexpr static std::array<int32_t, 10> POW10 = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
 
-Bigint::Bigint(int64_t value) {
-  if (value < 0) {
-    positive = false;
-    value *= -1;
-  } else {
-    positive = true;
-  }
+Bigint::Bigint(int64_t value) : Bigint(value, allocator_type()) {}
 
-  while (value != 0) {
-    number.push_back(value % 1000000000);
-    value /= 1000000000;
-  }
-}
-
-Bigint::Bigint(std::string_view string) {
-  int32_t size = string.length();
+Bigint::Bigint(const allocator_type &allocator) : number(allocator.resource()) {}
 
-  positive = string[0] != '-';
+Bigint::Bigint(const Bigint &bigint, const allocator_type &allocator) : number(bigint.number, allocator.resource()), positive(bigint.positive) {}
 
-  while (true) {
-    if (size <= 0) {
-      break;
-    }
-    if (!positive && size <= 1) {
-      break;
-    }
+Bigint::Bigint(Bigint &&bigint, const allocator_type &allocator) : number(allocator.resource()), positive(bigint.positive) {
+  number = std::move(bigint.number);
+}
 
-    int32_t length = 0;
-    int32_t num = 0;
+Bigint::Bigint(int64_t value, const allocator_type &allocator) : number(allocator.resource()), positive(value >= 0) {
+  uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
 
-    for (int32_t idx = size - 1; idx >= 0 && idx >= size - 9; --idx) {
-      if (string[idx] >= '0' && string[idx] <= '9') {
-        num += (string[idx] - '0') * POW10.at(length);
-      }
-      ++length;
-    }
-    number.push_back(num);
-    size -= length;
+  while (magnitude != 0) {
+    number.push_back(static_cast<Limb>(magnitude % limbs::BASE));
+    magnitude /= limbs::BASE;
   }
 }
 
-Bigint Bigint::operator+(const Bigint &right) const {
+Bigint Bigint::operator+(const Bigint &right) const & {
   Bigint c = *this;
   c += right;
 
   return c;
 }
 
-Bigint &Bigint::operator+=(const Bigint &right) {
-  if (positive && !right.positive) {
-    right.flip_sign();
+Bigint Bigint::operator+(const Bigint &right) && {
+  *this += right;
 
-    *this -= right;
+  return std::move(*this);
+}
 
-    right.flip_sign();
-    return *this;
-  }
-  if (!positive && right.positive) {
-    flip_sign();
+Bigint Bigint::operator+(Bigint &&right) const & {
+  right += *this;
 
-    *this -= right;
+  return std::move(right);
+}
 
-    flip_sign();
-    return *this;
+Bigint Bigint::operator+(Bigint &&right) && {
+  if (right.number.capacity() > number.capacity()) {
+    return std::move(right) + *this;
   }
 
-  number.resize(std::max(number.size(), right.number.size()), 0);
-
-  int32_t *ptr_left = number.begin();
-  int32_t *ptr_right = right.number.begin();
-  int32_t sum = 0;
-
-  while (ptr_left != number.end()) {
-    sum += *ptr_left;
+  return std::move(*this) + right;
+}
 
-    if (ptr_right != right.number.end()) {
-      sum += *ptr_right;
-      ++ptr_right;
-    }
-    *ptr_left = sum % 1000000000;
-    ptr_left++;
-    sum /= 1000000000;
-  }
-  if (sum != 0) {
-    number.push_back(1);
+Bigint &Bigint::operator+=(const Bigint &right) {
+  if (positive == right.positive) {
+    add_magnitude(right.number.begin(), right.number.size());
+  } else {
+    sub_magnitude(right.number.begin(), right.number.size());
   }
 
   return *this;
 }
 
-Bigint Bigint::operator+(const int64_t &value) const {
+Bigint Bigint::operator+(const int64_t &value) const & {
   Bigint c = *this;
   c += value;
 
   return c;
 }
 
-Bigint &Bigint::operator+=(int64_t value) {
-  if (value == 0) {
-    return *this;
-  }
-  if (positive && value < 0) {
-    return *this -= -value;
-  }
-  if (!positive && value > 0) {
-    flip_sign();
-
-    *this -= value;
+Bigint Bigint::operator+(const int64_t &value) && {
+  *this += value;
 
-    flip_sign();
-    return *this;
-  }
-  if (!positive && value < 0) {
-    value = -value;
-  }
+  return std::move(*this);
+}
 
-  int32_t *ptr = number.begin();
+Bigint &Bigint::operator+=(int64_t value) {
+  // Through the magnitude, since -value overflows for INT64_MIN
+  std::array<Limb, 3> digits{};
+  const size_t digits_size = limbs::word_limbs(value, digits);
 
-  while (value != 0) {
-    if (ptr != number.end()) {
-      *ptr += static_cast<int32_t>(value % 1000000000);
-      value /= 1000000000;
-      value += *ptr / 1000000000;
-      *ptr %= 1000000000;
-      ++ptr;
-    } else {
-      number.push_back(0);
-      ptr = number.end() - 1;
-    }
+  if (positive == (value >= 0)) {
+    add_magnitude(digits.data(), digits_size);
+  } else {
+    sub_magnitude(digits.data(), digits_size);
   }
 
   return *this;
 }
 
-Bigint Bigint::operator-(const Bigint &right) const {
+Bigint Bigint::operator-(const Bigint &right) const & {
   Bigint c = *this;
   c -= right;
 
   return c;
 }
 
-Bigint &Bigint::operator-=(const Bigint &right) {
-  if (Bigint() == right) {
-    return *this;
-  }
-  if (!positive || !right.positive) {
-    right.flip_sign();
+Bigint Bigint::operator-(const Bigint &right) && {
+  *this -= right;
 
-    *this += right;
+  return std::move(*this);
+}
 
+Bigint Bigint::operator-(Bigint &&right) const & {
+  // left - right == -(right - left)
+  right -= *this;
+  if (!right.number.empty()) {
     right.flip_sign();
-    return *this;
   }
 
-  int32_t *ptr_left = number.begin();
-  int32_t *ptr_right = right.number.begin();
-  int32_t diff = 0;
+  return std::move(right);
+}
 
-  while (ptr_left != number.end() || ptr_right != right.number.end()) {
-    if (ptr_left != number.end()) {
-      diff += *ptr_left;
-      ++ptr_left;
-    } else {
-      number.push_back(0);
-      ptr_left = number.end();
-    }
-    if (ptr_right != right.number.end()) {
-      diff -= *ptr_right;
-      ++ptr_right;
-    }
-    if (diff < 0) {
-      *(ptr_left - 1) = (diff + 1000000000) % 1000000000;
-      diff = -1;
-    } else {
-      *(ptr_left - 1) = diff % 1000000000;
-      diff /= 1000000000;
-    }
-  }
-  if (diff < 0) {
-    *this = Bigint(1).add_zeroes(9 * number.size()) - *this;
-    positive = false;
+Bigint Bigint::operator-(Bigint &&right) && {
+  if (right.number.capacity() > number.capacity()) {
+    return static_cast<const Bigint &>(*this) - std::move(right);
   }
-  while (!number.empty() && number.back() == 0) {
-    number.pop_back();
+
+  return std::move(*this) - right;
+}
+
+Bigint &Bigint::operator-=(const Bigint &right) {
+  if (positive != right.positive) {
+    add_magnitude(right.number.begin(), right.number.size());
+  } else {
+    sub_magnitude(right.number.begin(), right.number.size());
   }
 
   return *this;
 }
 
-Bigint Bigint::operator-(const int64_t &value) const {
+Bigint Bigint::operator-(const int64_t &value) const & {
   Bigint c = *this;
   c -= value;
 
   return c;
 }
 
-Bigint &Bigint::operator-=(int64_t value) {
-  if (value == 0) {
-    return *this;
-  }
-  if (!positive || value < 0) {
-    return *this += -value;
-  }
-
-  int32_t *ptr = number.begin();
-  int64_t diff = 0;
+Bigint Bigint::operator-(const int64_t &value) && {
+  *this -= value;
 
-  while (ptr != number.end() || value != 0) {
-    if (ptr != number.end()) {
-      diff += *ptr;
-      ++ptr;
-    } else {
-      number.push_back(0);
-      ptr = number.end();
-    }
+  return std::move(*this);
+}
 
-    diff -= value % 1000000000;
-    value /= 1000000000;
+Bigint &Bigint::operator-=(int64_t value) {
+  std::array<Limb, 3> digits{};
+  const size_t digits_size = limbs::word_limbs(value, digits);
 
-    if (diff < 0) {
-      *(ptr - 1) = static_cast<int32_t>((diff + 1000000000) % 1000000000);
-      diff = -1;
-    } else {
-      *(ptr - 1) = static_cast<int32_t>(diff % 1000000000);
-      diff /= 1000000000;
-    }
-  }
-  if (diff < 0) {
-    *this = Bigint(1).add_zeroes(9 * number.size()) - *this;
-    positive = false;
-  }
-  while (!number.empty() && number.back() == 0) {
-    number.pop_back();
+  if (positive == (value >= 0)) {
+    sub_magnitude(digits.data(), digits_size);
+  } else {
+    add_magnitude(digits.data(), digits_size);
   }
 
   return *this;
@@ -247,138 +162,121 @@ Bigint Bigint::operator-() {
   return *this;
 }
 
-Bigint Bigint::operator*(const Bigint &right) const {
-  if (right.number.size() == 1) {
-    Bigint left = *this;
-    left *= right.positive ? right.number[0] : -right.number[0];
-    return left;
-  }
-
-  Bigint result(0);
-  int64_t sum = 0;
-
-  result.number.reserve(number.size() + right.number.size());
-
-  int32_t start = 0;
-
-  for (int32_t val_left : number) {
-    int32_t *ptr_result = result.number.begin() + start;
-    for (int32_t it2 : right.number) {
-      sum += static_cast<int64_t>(val_left) * it2;
-      if (ptr_result == result.number.end()) {
-        result.number.push_back(sum % 1000000000);
-        ptr_result = result.number.end();
-      } else {
-        sum += *ptr_result;
-        *ptr_result = static_cast<int32_t>(sum % 1000000000);
-        ++ptr_result;
-      }
-      sum /= 1000000000;
-    }
-    if (sum != 0) {
-      result.number.push_back(sum % 1000000000);
-      sum = 0;
-    }
-    ++start;
-  }
-
-  result.positive = positive == right.positive;
-
-  return result;
-}
-
-Bigint &Bigint::operator*=(const Bigint &right) {
-  *this = *this * right;
-
-  return *this;
-}
-
-Bigint Bigint::operator*(int64_t value) const {
+Bigint Bigint::operator*(int64_t value) const & {
   Bigint c = *this;
   c *= value;
 
   return c;
 }
 
+Bigint Bigint::operator*(int64_t value) && {
+  *this *= value;
+
+  return std::move(*this);
+}
+
 Bigint &Bigint::operator*=(const int64_t &value) {
-  if (value == 0) {
+  while (!number.empty() && number.back() == 0) {
+    number.pop_back();
+  }
+  if (value == 0 || number.empty()) {
     clear();
 
     return *this;
   }
-  bool value_sign = true;
-  int64_t copy_value = value;
 
-  if (value < 0) {
-    copy_value = -copy_value;
-    value_sign = false;
-  }
+  const uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
 
-  if (copy_value >= 1000000000000000000) {
-    *this = *this * Bigint(value);
+  if (magnitude >= limbs::BASE) {
+    Bigint product(get_allocator());
+    product.addmul_1(*this, value);
+    *this = std::move(product);
 
     return *this;
   }
 
-  positive = value_sign == positive;
+  const uint32_t carry = limbs::mul_1(number.begin(), number.size(), static_cast<uint32_t>(magnitude));
+  if (carry != 0) {
+    number.push_back(static_cast<Limb>(carry));
+  }
+  positive = positive == (value > 0);
 
-  SmallVector<int32_t> result;
-  result.reserve(number.size());
+  return *this;
+}
 
-  int32_t *ptr_left = number.begin();
-  int64_t sum = 0;
+Bigint &Bigint::pow(uint64_t power) {
+  const bool result_positive = positive || power % 2 == 0;
 
-  int64_t lowPart = copy_value % 1000000000;
-  int64_t highPart = copy_value / 1000000000;
+  if (power == 0) {
+    clear();
+    number.push_back(1);
+    positive = true;
 
-  while (ptr_left != number.end()) {
-    sum += lowPart * (*ptr_left);
-    result.push_back(sum % 1000000000);
-    sum /= 1000000000;
-    ++ptr_left;
+    return *this;
   }
-  if (sum != 0) {
-    result.push_back(sum);
-    sum = 0;
+  if (number.empty() || power == 1) {
+    return *this;
   }
 
-  if (highPart != 0) {
-    ptr_left = number.begin();
-
-    int32_t *ptr_result = result.begin() + 1;
+  uint32_t bits = 0;
+  while (bits < 64 && (power >> bits) != 0) {
+    ++bits;
+  }
 
-    while (ptr_left != number.end()) {
-      sum += highPart * (*ptr_left);
-      if (ptr_result == result.end()) {
-        result.push_back(sum % 1000000000);
-      } else {
-        *ptr_result += static_cast<int32_t>(sum % 1000000000);
-      }
-      sum /= 1000000000;
-      ++ptr_left;
-      ++ptr_result;
-    }
-    if (sum != 0) {
-      result.push_back(sum);
+  // Left-to-right sliding window: odd_powers[i] = |this|^(2i + 1) for window values up to 2^width - 1.
+  const uint32_t width = bits > 24 ? 4 : bits > 8 ? 3 : bits > 3 ? 2 : 1;
+  const size_t table_size = size_t{ 1 } << (width - 1);
+  std::vector<Bigint> odd_powers;
+  odd_powers.reserve(table_size);
+  odd_powers.emplace_back(*this);
+  odd_powers.back().positive = true;
+  if (width > 1) {
+    Bigint base_squared = odd_powers.back();
+    base_squared.square();
+    while (odd_powers.size() < table_size) {
+      odd_powers.push_back(odd_powers.back() * base_squared);
     }
   }
 
-  number = std::move(result);
+  Bigint result(get_allocator());
+  bool started = false;
+  for (int32_t bit = static_cast<int32_t>(bits) - 1; bit >= 0;) {
+    if (((power >> bit) & 1U) == 0) {
+      result.square();
+      --bit;
+      continue;
+    }
 
-  return *this;
-}
+    int32_t low = std::max(bit - static_cast<int32_t>(width) + 1, 0);
+    while (((power >> low) & 1U) == 0) {
+      ++low;
+    }
+    const uint64_t window = (power >> low) & ((uint64_t{ 1 } << (bit - low + 1)) - 1);
 
-Bigint &Bigint::pow(const uint32_t &power) {
-  std::map<int32_t, Bigint> lookup;
-  if (power % 2 == 0 && !positive) {
-    positive = true;
+    if (!started) {
+      result = odd_powers[window / 2];
+      started = true;
+    } else {
+      for (int32_t i = low; i <= bit; ++i) {
+        result.square();
+      }
+      result *= odd_powers[window / 2];
+    }
+    bit = low - 1;
   }
-  *this = pow(power, &lookup);
+
+  *this = std::move(result);
+  positive = result_positive || number.empty() || (number.size() == 1 && number[0] == 0);
 
   return *this;
 }
 
 int32_t Bigint::digits() const {
+  if constexpr (limbs::BINARY) {
+    const std::string string = to_string();
+    return static_cast<int32_t>(string.size()) - (string[0] == '-' ? 1 : 0);
+  }
+
   int32_t segments = number.size();
 
   if (segments == 0) {
@@ -401,146 +299,17 @@ bool Bigint::is_negative() const {
   return !positive;
 }
 
-Bigint Bigint::get_fragment(const Bigint &bigint, int32_t which) {
-  int32_t *ptr = bigint.number.end() - 1;
-  const int32_t size_at_end = static_cast<int32_t>(std::log10(*ptr)) + 1;
-
-  if (bigint.number.size() == 1 || size_at_end >= which) {
-    return Bigint((*ptr / POW10.at(size_at_end - which)));
-  }
-
-  if (bigint.digits() <= which) {
-    return Bigint(bigint);
-  }
-
-  which -= size_at_end;
-  --ptr;
-
-  int32_t idx = which / 9;
-  ptr -= idx;
-  which -= idx * 9;
-
-  int32_t pow = POW10.at(9 - which);
-  int32_t pow2 = 1000000000 / pow;
-
-  Bigint result((*ptr) / pow);
-
-  result.number.reserve(std::distance(ptr, bigint.number.end()));
-
-  ++ptr;
-
-  idx = 0;
-
-  for (; ptr < bigint.number.end(); ++ptr) {
-    result.number.push_back((*ptr) / pow);
-    result.number[idx] += ((*ptr) % pow) * pow2;
-    idx++;
-  }
-
-  if (result.number.back() == 0) {
-    result.number.pop_back();
-  }
-
-  return result;
-}
-
-Bigint Bigint::operator/(Bigint right) {
-  if (right == Bigint()) {
-    throw std::invalid_argument("Divisor must be non zero");
-  }
-
-  Bigint left = *this;
-
-  positive = positive == right.positive;
-
-  left.positive = true;
-  right.positive = true;
-
-  if (left < right) {
-    clear();
-
-    return *this;
-  }
-  if (number.size() == 1) {
-    number[0] = number[0] / right.number[0];
-
-    return *this;
-  }
-
-  Bigint sum_quotient;
-  Bigint frag_left;
-  Bigint temp;
-  uint32_t temp_quotient = 0;
-
-  const std::array<Bigint, 4> look_up = { right, right * 2, right * 4, right * 8 };
-
-  const std::array<int32_t, 4> look_up_digits = {
-    look_up[0].digits(),
-    look_up[1].digits(),
-    look_up[2].digits(),
-    look_up[3].digits()
-  };
-
-  while (true) {
-    const int32_t digits_left = left.digits();
-    int32_t digits_right = look_up_digits[3];
-
-    if (digits_left - look_up_digits[0] < 0) {
-      sum_quotient.positive = positive;
-      return sum_quotient;
-    }
-
-    if (digits_left - digits_right < 0) {
-      frag_left = get_fragment(left, look_up_digits[0]);
-    } else {
-      frag_left = get_fragment(left, digits_right);
-    }
-
-    for (uint8_t i = 3; i >= 0; i--) {
-      if (frag_left >= look_up.at(i)) {
-        temp = look_up.at(i);
-        digits_right = look_up_digits.at(i);
-        temp_quotient = 1U << i;
-        break;
-      }
-      if (i == 0) {
-        sum_quotient.positive = positive;
-        return sum_quotient;
-      }
-    }
-
-    const int32_t number_of_zeroes = digits_left - look_up_digits[3] - look_up_digits[3] + digits_right;
-
-    if (number_of_zeroes > 0) {
-      sum_quotient = sum_quotient + Bigint(temp_quotient).add_zeroes(number_of_zeroes);
-      left = left - temp.add_zeroes(number_of_zeroes);
-    } else {
-      sum_quotient = sum_quotient + temp_quotient;
-      left = left - temp;
-    }
-  }
-}
-
-Bigint &Bigint::operator/=(const Bigint &right) {
-  *this = *this / right;
-
-  return *this;
+Bigint::allocator_type Bigint::get_allocator() const {
+  return number.get_resource();
 }
 
 int64_t Bigint::operator%(const int64_t &value) const {
-  if (number.empty()) {
-    return 0;
+  if (value == 0) {
+    throw std::invalid_argument("Divisor must be non zero");
   }
-  int64_t remains = 0;
-  const size_t s = number.size() - 1;
 
-  for (size_t i = 0; i < number.size(); i++) {
-    remains = (remains + number[s - i]) % value;
-    if (i != s) {
-      remains *= 1000000000;
-      remains %= value;
-    }
-  }
+  const uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+  const auto remains = static_cast<int64_t>(limbs::mod_1(number.begin(), number.size(), limbs::Divisor(magnitude)));
 
   return positive ? remains : -remains;
 }
@@ -570,7 +339,7 @@ bool Bigint::operator!=(const Bigint &other) const {
 }
 
 Bigint &Bigint::operator=(const std::string &string) {
-  Bigint temp(string);
+  Bigint temp(string, get_allocator());
   number = std::move(temp.number);
   positive = temp.positive;
 
@@ -584,6 +353,11 @@ int32_t Bigint::operator()(const int32_t &which) const {
     throw std::out_of_range("Number out of bounds");
   }
 
+  if constexpr (limbs::BINARY) {
+    const std::string string = to_string();
+    return string[string.size() - 1 - which] - '0';
+  }
+
   if (which == 0) {
     return number[0] % 10;
   }
@@ -598,6 +372,11 @@ int32_t Bigint::operator[](const int32_t &which) const {
     throw std::out_of_range("Number out of bounds");
   }
 
+  if constexpr (limbs::BINARY) {
+    const std::string string = to_string();
+    return string[string.size() - size + which] - '0';
+  }
+
   if (which == 0 && number.back() < 10) {
     return number.back();
   }
@@ -631,13 +410,6 @@ Bigint &Bigint::abs() {
   return *this;
 }
 
-std::string Bigint::to_string() const {
-  std::ostringstream stream;
-  stream << *this;
-
-  return stream.str();
-}
-
 Bigint Bigint::clone() const {
   return Bigint(*this);
 }
@@ -650,77 +422,6 @@ constexpr int32_t Bigint::segment_length(int32_t segment) {
   return static_cast<int32_t>(std::log10(segment)) + 1;
 }
 
-std::istream &operator>>(std::istream &stream, Bigint &bigint) {
-  std::string string;
-  stream >> string;
-
-  bigint = Bigint(string);
-
-  return stream;
-}
-
-std::ostream &operator<<(std::ostream &stream, const Bigint &bigint) {
-  if (bigint.number.empty()) {
-    return stream << '0';
-  }
-
-  int64_t length = bigint.number.size() - 1;
-  for (; length >= 0 && bigint.number[length] == 0; --length) {};
-
-  if (length == -1) {
-    return stream << '0';
-  }
-  if (!bigint.positive) {
-    stream << '-';
-  }
-
-  int32_t *ptr = bigint.number.end() - bigint.number.size() + length;
-
-  stream << *ptr--;
-
-  for (; ptr != bigint.number.begin() - 1; --ptr) {
-    for (int32_t idx = 0, segment = bigint.segment_length(*ptr); idx < 9 - segment; ++idx) {
-      stream << '0';
-    }
-    if (*ptr != 0) {
-      stream << *ptr;
-    }
-  }
-
-  return stream;
-}
-
-Bigint Bigint::pow(const uint32_t &power, std::map<int32_t, Bigint> *lookup) {
-  if (power == 1) {
-    return *this;
-  }
-  if (power == 0) {
-    clear();
-    number.push_back(1);
-
-    return *this;
-  }
-
-  if (lookup->count(power) != 0) {
-    return lookup->at(power);
-  }
-
-  uint32_t closest_power = 1;
-  while (closest_power < power) {
-    closest_power <<= 1U;
-  }
-  closest_power >>= 1U;
-
-  if (power == closest_power) {
-    Bigint half = pow(power / 2, lookup);
-    lookup->emplace(std::pair<int32_t, Bigint>(power, half * half));
-  } else {
-    lookup->emplace(std::pair<int32_t, Bigint>(power, pow(closest_power, lookup) * pow(power - closest_power, lookup)));
-  }
-
-  return lookup->at(power);
-}
-
 int8_t Bigint::compare(const Bigint &right) const {
   if (right.number.empty()) {
     if (number.empty()) {
@@ -767,35 +468,82 @@ int8_t Bigint::compare(const Bigint &right) const {
   return 0;
 }
 
-void Bigint::flip_sign() const {
+void Bigint::add_magnitude(const Limb *right, size_t right_size) {
+  while (right_size > 0 && right[right_size - 1] == 0) {
+    --right_size;
+  }
+
+  number.resize(std::max(number.size(), right_size), 0);
+
+  if (limbs::add_in_place(number.begin(), number.size(), right, right_size) != 0) {
+    number.push_back(1);
+  }
+}
+
+void Bigint::sub_magnitude(const Limb *right, size_t right_size) {
+  const int8_t order = limbs::compare(number.begin(), number.size(), right, right_size);
+
+  if (order == 0) {
+    clear();
+    return;
+  }
+
+  if (order > 0) {
+    while (right_size > 0 && right[right_size - 1] == 0) {
+      --right_size;
+    }
+
+    limbs::sub_in_place(number.begin(), number.size(), right, right_size);
+  } else {
+    // |right| is larger: compute right - this into this, reading each own limb before overwriting it.
+    number.resize(std::max(number.size(), right_size), 0);
+
+    uint64_t borrow = 0;
+    for (size_t idx = 0; idx < number.size(); ++idx) {
+      const uint64_t diff = static_cast<uint64_t>(idx < right_size ? right[idx] : 0) - static_cast<uint64_t>(number[idx]) - borrow;
+      borrow = diff >> 63U;
+      number[idx] = static_cast<Limb>(borrow != 0 ? diff + limbs::BASE : diff);
+    }
+
+    positive = !positive;
+  }
+
+  while (!number.empty() && number.back() == 0) {
+    number.pop_back();
+  }
+}
+
+void Bigint::flip_sign() {
   positive = !positive;
 }
 
 Bigint &Bigint::add_zeroes(uint32_t amount) {
-  if (amount == 0) {
+  if (amount == 0 || number.empty()) {
     return *this;
   }
 
-  const int64_t power_of_ten = POW10.at(amount % 9);
+  if constexpr (limbs::BINARY) {
+    // 10^amount = 5^amount * 2^amount, and the power of two is a shift
+    Bigint power(5, get_allocator());
+    *this *= power.pow(amount);
+    return *this <<= amount;
+  }
+
+  const auto power_of_ten = static_cast<uint32_t>(POW10.at(amount % 9));
 
   if (power_of_ten != 1) {
-    int32_t accumulator = 0;
-    for (int32_t &ptr : number) {
-      int64_t mul = power_of_ten * ptr;
-      ptr = static_cast<int32_t>((mul + accumulator) % 1000000000);
-      accumulator = static_cast<int32_t>(mul / 1000000000);
-    }
-    if (accumulator != 0) {
-      number.push_back(accumulator);
+    const uint32_t carry = limbs::mul_1(number.begin(), number.size(), power_of_ten);
+    if (carry != 0) {
+      number.push_back(static_cast<Limb>(carry));
     }
   }
 
   if (amount / 9 > 0) {
-    std::reverse(number.begin(), number.end());
+    const size_t size = number.size();
 
-    number.resize(number.size() + amount / 9, 0);
-
-    std::reverse(number.begin(), number.end());
+    number.resize(size + amount / 9, 0);
+    std::copy_backward(number.begin(), number.begin() + size, number.end());
+    std::fill(number.begin(), number.begin() + amount / 9, 0);
   }
 
   return *this;
@@ -810,15 +558,26 @@ Bigint &Bigint::remove_trailing(uint32_t amount) {
     return *this;
   }
 
+  if constexpr (limbs::BINARY) {
+    // floor(|this| / 10^amount) = floor(floor(|this| / 2^amount) / 5^amount)
+    const bool result_positive = positive;
+    positive = true;
+    *this >>= amount;
+    Bigint power(5, get_allocator());
+    *this = *this / power.pow(amount);
+    positive = result_positive || number.empty();
+    return *this;
+  }
+
   std::reverse(number.begin(), number.end());
 
   const int32_t power_of_ten = POW10.at(amount % 9);
   const int32_t power_of_ten_complement = POW10.at(9 - amount % 9);
 
   if (power_of_ten != 1) {
-    int32_t accumulator = 0;
-    for (int32_t &ptr : number) {
-      int32_t temp = ptr % power_of_ten;
+    Limb accumulator = 0;
+    for (Limb &ptr : number) {
+      const Limb temp = ptr % power_of_ten;
       ptr = power_of_ten_complement * accumulator + ptr / power_of_ten;
       accumulator = temp;
     }
@@ -837,11 +596,4 @@ Bigint &Bigint::remove_trailing(uint32_t amount) {
   return *this;
 }
 
-std::string to_string(const Bigint &bigint) {
-  std::ostringstream stream;
-  stream << bigint;
-
-  return stream.str();
-}
-
 }// namespace BigMath
@@ -0,0 +1,481 @@
+#include "bigint.h"
+#include "limbs.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace BigMath {
+
+namespace {
+
+// Words (of 32 bits) from which the conversions split the number in two instead of going word by word.
+constexpr size_t BINARY_BASECASE = 16;
+
+constexpr uint32_t HALF_WORD = 1U << 16U;
+
+// Largest power of two dividing BASE: 2^9 divides 10^9.
+constexpr uint64_t BASE_BITS = limbs::BINARY ? 32 : 9;
+
+uint32_t word_bits(uint32_t word) {
+  uint32_t bits = 0;
+  for (; word != 0; word >>= 1U) {
+    ++bits;
+  }
+
+  return bits;
+}
+
+uint32_t count_bits(uint32_t word) {
+  word = word - ((word >> 1U) & 0x55555555U);
+  word = (word & 0x33333333U) + ((word >> 2U) & 0x33333333U);
+  word = (word + (word >> 4U)) & 0x0F0F0F0FU;
+
+  return (word * 0x01010101U) >> 24U;
+}
+
+uint32_t count_trailing_zero_bits(uint32_t word) {// word non-zero
+  uint32_t count = 0;
+  for (; (word & 1U) == 0; word >>= 1U) {
+    ++count;
+  }
+
+  return count;
+}
+
+// words = -words modulo 2^(32 * size)
+void negate(std::vector<uint32_t> &words) {
+  uint32_t carry = 1;
+  for (uint32_t &word : words) {
+    word = ~word + carry;
+    carry = carry != 0 && word == 0 ? 1 : 0;
+  }
+}
+
+}// namespace
+
+// Conversion between decimal limbs and little endian 32-bit words. Both directions split the number at
+// 2^(32 * BINARY_BASECASE * 2^i), so the cost is that of the multiplications and divisions by those powers
+// rather than quadratic in the size. Binary limbs already are the words and are copied.
+struct Binary {
+  using Words = std::vector<uint32_t>;
+
+  std::vector<Bigint> powers;// powers[i] = 2^(32 * BINARY_BASECASE << i)
+
+  explicit Binary(const Bigint::allocator_type &allocator) {
+    Bigint first(1, allocator);
+    first <<= 32 * BINARY_BASECASE;
+    powers.push_back(std::move(first));
+  }
+
+  const Bigint &power(size_t level) {
+    while (powers.size() <= level) {
+      Bigint next(powers.back());
+      powers.push_back(std::move(next.square()));
+    }
+
+    return powers[level];
+  }
+
+  static size_t size(const Bigint &x) {
+    size_t limbs = x.number.size();
+    while (limbs > 0 && x.number[limbs - 1] == 0) {
+      --limbs;
+    }
+
+    return limbs;
+  }
+
+  // Words of |x|, without leading zero words
+  Words to_words(const Bigint &x) {
+    if constexpr (limbs::BINARY) {
+      return Words(x.number.begin(), x.number.begin() + size(x));
+    }
+
+    size_t level = 0;
+    while (limbs::compare(x.number.begin(), size(x), power(level).number.begin(), power(level).number.size()) >= 0) {
+      ++level;
+    }
+
+    Words words(BINARY_BASECASE << level);
+    Bigint magnitude(x);
+    split(magnitude.abs(), level, words.data());
+    while (!words.empty() && words.back() == 0) {
+      words.pop_back();
+    }
+
+    return words;
+  }
+
+  // out[0, BINARY_BASECASE << level) = words of x, for 0 <= x < 2^(32 * BINARY_BASECASE << level)
+  void split(const Bigint &x, size_t level, uint32_t *out) {
+    if (level == 0) {
+      std::vector<Limb> digits(x.number.begin(), x.number.begin() + size(x));
+      for (size_t i = 0; !digits.empty(); ++i) {
+        const uint32_t low = limbs::div_1(digits.data(), digits.size(), HALF_WORD);
+        const uint32_t high = limbs::div_1(digits.data(), digits.size(), HALF_WORD);
+        out[i] = (high << 16U) | low;
+        while (!digits.empty() && digits.back() == 0) {
+          digits.pop_back();
+        }
+      }
+      return;
+    }
+
+    if (size(x) < power(level - 1).number.size()) {
+      split(x, level - 1, out);
+      return;
+    }
+    auto [high, low] = divmod(x, power(level - 1));
+    split(low, level - 1, out);
+    split(high, level - 1, out + (BINARY_BASECASE << (level - 1)));
+  }
+
+  // The non-negative number with the given words
+  Bigint from_words(const Words &words, const Bigint::allocator_type &allocator) {
+    if constexpr (limbs::BINARY) {
+      Bigint result(allocator);
+      result.number.resize(words.size());
+      std::copy(words.begin(), words.end(), result.number.begin());
+      while (!result.number.empty() && result.number.back() == 0) {
+        result.number.pop_back();
+      }
+
+      return result;
+    }
+
+    size_t level = 0;
+    while ((BINARY_BASECASE << level) < words.size()) {
+      ++level;
+    }
+
+    Words padded(words);
+    padded.resize(BINARY_BASECASE << level);
+    return join(padded.data(), level, allocator);
+  }
+
+  Bigint join(const uint32_t *words, size_t level, const Bigint::allocator_type &allocator) {
+    const size_t count = BINARY_BASECASE << level;
+    if (level == 0) {
+      // 32 bits take less than 1.125 limbs of 29.9 bits
+      Bigint result(allocator);
+      result.number.resize(count + count / 8 + 1);
+      Limb *ptr = result.number.begin();
+      size_t used = 0;
+      for (size_t i = count; i-- > 0;) {
+        for (uint32_t half : { words[i] >> 16U, words[i] & (HALF_WORD - 1) }) {
+          const uint32_t carry = limbs::mul_1(ptr, used, HALF_WORD);
+          if (carry != 0) {
+            ptr[used++] = static_cast<Limb>(carry);
+          }
+          for (size_t j = 0; half != 0; ++j) {
+            if (j == used) {
+              ptr[used++] = 0;
+            }
+            const uint32_t sum = static_cast<uint32_t>(ptr[j]) + half;
+            half = sum >= limbs::BASE ? 1 : 0;
+            ptr[j] = static_cast<Limb>(sum - half * limbs::BASE);
+          }
+        }
+      }
+      while (!result.number.empty() && result.number.back() == 0) {
+        result.number.pop_back();
+      }
+
+      return result;
+    }
+
+    const size_t half = count / 2;
+    Bigint result = join(words, level - 1, allocator);
+    if (std::any_of(words + half, words + count, [](uint32_t word) { return word != 0; })) {
+      result.addmul(join(words + half, level - 1, allocator), power(level - 1));
+    }
+
+    return result;
+  }
+
+  // Two's complement of x over the given number of words, which must leave room for the sign bit
+  Words complement(const Bigint &x, size_t count) {
+    Words words = to_words(x);
+    words.resize(count);
+    if (x.is_negative()) {
+      negate(words);
+    }
+
+    return words;
+  }
+
+  // x and y combined word by word as infinitely sign extended two's complement numbers
+  template<typename Operation>
+  Bigint combine(const Bigint &x, const Bigint &y, Operation operation) {
+    const size_t count = std::max(to_words_bound(x), to_words_bound(y)) + 1;
+    Words left = complement(x, count);
+    const Words right = complement(y, count);
+    for (size_t i = 0; i < count; ++i) {
+      left[i] = operation(left[i], right[i]);
+    }
+
+    const bool negative = (left.back() >> 31U) != 0;
+    if (negative) {
+      negate(left);
+    }
+    Bigint result = from_words(left, x.get_allocator());
+    if (negative) {
+      result.flip_sign();
+    }
+
+    return result;
+  }
+
+  // At least the number of words in |x|, since a limb holds no more bits than a word
+  static size_t to_words_bound(const Bigint &x) {
+    return size(x) + 1;
+  }
+};
+
+Bigint Bigint::operator<<(uint64_t shift) const {
+  Bigint result(*this);
+  result <<= shift;
+
+  return result;
+}
+
+Bigint &Bigint::operator<<=(uint64_t shift) {
+  if constexpr (limbs::BINARY) {
+    const size_t size = Binary::size(*this);
+    if (size == 0) {
+      clear();
+      return *this;
+    }
+
+    // Each limb goes to its place shift / 32 limbs up, split between two limbs by the remaining bits
+    const size_t limb_shift = shift / 32;
+    const uint64_t bit_shift = shift % 32;
+    number.resize(size + limb_shift + 1, 0);
+    Limb *ptr = number.begin();
+    for (size_t i = size; i-- > 0;) {
+      const uint64_t wide = static_cast<uint64_t>(ptr[i]) << bit_shift;
+      ptr[i + limb_shift + 1] |= static_cast<Limb>(wide >> 32U);
+      ptr[i + limb_shift] = static_cast<Limb>(wide);
+    }
+    std::fill(ptr, ptr + limb_shift, 0);
+    while (number.back() == 0) {
+      number.pop_back();
+    }
+
+    return *this;
+  }
+
+  if (shift < 63) {
+    return *this *= static_cast<int64_t>(uint64_t{ 1 } << shift);
+  }
+
+  Bigint power(2, get_allocator());
+  return *this *= power.pow(shift);
+}
+
+Bigint Bigint::operator>>(uint64_t shift) const {
+  Bigint result(*this);
+  result >>= shift;
+
+  return result;
+}
+
+Bigint &Bigint::operator>>=(uint64_t shift) {
+  if (shift >= bit_length()) {
+    const bool negative = is_negative() && Binary::size(*this) != 0;
+    clear();
+    if (negative) {
+      *this -= 1;
+    }
+    return *this;
+  }
+
+  if constexpr (limbs::BINARY) {
+    // Floor division: a negative number whose dropped bits are not all zero moves one further from zero
+    const size_t size = Binary::size(*this);
+    const size_t limb_shift = shift / 32;
+    const uint64_t bit_shift = shift % 32;
+    Limb *ptr = number.begin();
+    bool dropped = std::any_of(ptr, ptr + limb_shift, [](Limb limb) { return limb != 0; })
+                   || (ptr[limb_shift] & ((Limb{ 1 } << bit_shift) - 1)) != 0;
+    for (size_t i = limb_shift; i < size; ++i) {
+      const uint64_t next = i + 1 < size ? static_cast<uint64_t>(ptr[i + 1]) << 32U : 0;
+      ptr[i - limb_shift] = static_cast<Limb>((next | ptr[i]) >> bit_shift);
+    }
+    while (number.size() > size - limb_shift) {
+      number.pop_back();
+    }
+    while (!number.empty() && number.back() == 0) {
+      number.pop_back();
+    }
+    if (is_negative() && dropped) {
+      const Limb one = 1;
+      add_magnitude(&one, 1);
+    }
+
+    return *this;
+  }
+
+  Bigint power(1, get_allocator());
+  power <<= shift;
+  auto [quotient, remainder] = divmod(*this, power);
+  if (remainder.is_negative() && Binary::size(remainder) != 0) {
+    quotient -= 1;
+  }
+  *this = std::move(quotient);
+
+  return *this;
+}
+
+Bigint Bigint::operator&(const Bigint &right) const {
+  // A non-negative operand clears every bit above its own, so only that many low bits of the other one matter.
+  const bool left_wide = is_negative() || (!right.is_negative() && Binary::size(right) < Binary::size(*this));
+  const Bigint &mask = left_wide ? right : *this;
+  const Bigint &wide = left_wide ? *this : right;
+  if (!mask.is_negative() && Binary::to_words_bound(mask) < Binary::size(wide)) {
+    Bigint power(1, get_allocator());
+    power <<= 32 * Binary::to_words_bound(mask);
+    Bigint low = wide % power;
+    if (low.is_negative() && Binary::size(low) != 0) {
+      low += power;
+    }
+
+    Binary binary(get_allocator());
+    return binary.combine(low, mask, [](uint32_t x, uint32_t y) { return x & y; });
+  }
+
+  Binary binary(get_allocator());
+  return binary.combine(*this, right, [](uint32_t x, uint32_t y) { return x & y; });
+}
+
+Bigint &Bigint::operator&=(const Bigint &right) {
+  *this = *this & right;
+
+  return *this;
+}
+
+Bigint Bigint::operator|(const Bigint &right) const {
+  Binary binary(get_allocator());
+  return binary.combine(*this, right, [](uint32_t x, uint32_t y) { return x | y; });
+}
+
+Bigint &Bigint::operator|=(const Bigint &right) {
+  *this = *this | right;
+
+  return *this;
+}
+
+Bigint Bigint::operator^(const Bigint &right) const {
+  Binary binary(get_allocator());
+  return binary.combine(*this, right, [](uint32_t x, uint32_t y) { return x ^ y; });
+}
+
+Bigint &Bigint::operator^=(const Bigint &right) {
+  *this = *this ^ right;
+
+  return *this;
+}
+
+Bigint Bigint::operator~() const {
+  Bigint result(*this);
+  result.flip_sign();
+  result -= 1;
+
+  return result;
+}
+
+uint64_t Bigint::bit_length() const {
+  const size_t limb_count = Binary::size(*this);
+  if (limb_count == 0) {
+    return 0;
+  }
+
+  if constexpr (limbs::BINARY) {
+    return 32 * (limb_count - 1) + word_bits(number[limb_count - 1]);
+  }
+
+  // log2 from the three leading limbs, checked against the power of two when it lands too close to one
+  const size_t leading_limbs = std::min<size_t>(limb_count, 3);
+  double leading = 0;
+  for (size_t i = limb_count; i > limb_count - leading_limbs; --i) {
+    leading = leading * limbs::BASE + number[i - 1];
+  }
+  const double log = std::log2(leading) + static_cast<double>(limb_count - leading_limbs) * std::log2(static_cast<double>(limbs::BASE));
+  const double nearest = std::round(log);
+  if (std::abs(log - nearest) > 1e-6) {
+    return static_cast<uint64_t>(log) + 1;
+  }
+
+  const auto bits = static_cast<uint64_t>(nearest);
+  Bigint power(1, get_allocator());
+  power <<= bits;
+
+  return limbs::compare(number.begin(), limb_count, power.number.begin(), power.number.size()) >= 0 ? bits + 1 : bits;
+}
+
+uint64_t Bigint::count_trailing_zeros() const {
+  const size_t limb_count = Binary::size(*this);
+  size_t zero_limbs = 0;
+  while (zero_limbs < limb_count && number[zero_limbs] == 0) {
+    ++zero_limbs;
+  }
+  if (zero_limbs == limb_count) {
+    return 0;
+  }
+
+  // this = y * BASE^zero_limbs, and the low m limbs of y decide its trailing zeros once those are below BASE_BITS * m
+  Binary binary(get_allocator());
+  for (size_t low_limbs = 1;; low_limbs *= 2) {
+    const size_t used = std::min(low_limbs, limb_count - zero_limbs);
+    Bigint low(get_allocator());
+    low.number.resize(used);
+    std::copy(number.begin() + zero_limbs, number.begin() + zero_limbs + used, low.number.begin());
+
+    const Binary::Words words = binary.to_words(low);
+    size_t zeros = 0;
+    size_t word = 0;
+    for (; words[word] == 0; ++word) {
+      zeros += 32;
+    }
+    zeros += count_trailing_zero_bits(words[word]);
+
+    if (zeros < BASE_BITS * used || used == limb_count - zero_limbs) {
+      return BASE_BITS * zero_limbs + zeros;
+    }
+  }
+}
+
+uint64_t Bigint::popcount() const {
+  Binary binary(get_allocator());
+  uint64_t count = 0;
+  for (const uint32_t word : binary.to_words(*this)) {
+    count += count_bits(word);
+  }
+
+  return count;
+}
+
+bool Bigint::test_bit(uint64_t index) const {
+  const size_t limb_count = Binary::size(*this);
+  if (index >= bit_length()) {
+    return is_negative() && limb_count != 0;
+  }
+
+  // BASE^m is a multiple of 2^(BASE_BITS * m), so the low m limbs, with this number's sign, agree with it on every bit
+  // below BASE_BITS * m, negative numbers included. Only those limbs are shifted.
+  const size_t used = std::min<size_t>(index / BASE_BITS + 1, limb_count);
+  Bigint low(get_allocator());
+  low.number.resize(used);
+  std::copy(number.begin(), number.begin() + used, low.number.begin());
+  while (!low.number.empty() && low.number.back() == 0) {
+    low.number.pop_back();
+  }
+  if (is_negative()) {
+    low.flip_sign();
+  }
+
+  return !(low >> index).is_even();
+}
+
+}// namespace BigMath
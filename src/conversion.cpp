@@ -0,0 +1,312 @@
+#include "bigint.h"
+#include "limbs.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace BigMath {
+
+namespace {
+
+// Nine digit chunks from which the binary limb conversions split the number in two instead of going chunk by chunk.
+constexpr size_t DECIMAL_BASECASE = 64;
+
+constexpr uint32_t CHUNK = 1000000000;
+
+// "00" .. "99", so a limb is printed two digits per lookup.
+constexpr char DIGIT_PAIRS[] = "00010203040506070809"
+                               "10111213141516171819"
+                               "20212223242526272829"
+                               "30313233343536373839"
+                               "40414243444546474849"
+                               "50515253545556575859"
+                               "60616263646566676869"
+                               "70717273747576777879"
+                               "80818283848586878889"
+                               "90919293949596979899";
+
+// Writes the nine zero padded digits of a limb to out[0, 9).
+void write_limb(char *out, uint32_t limb) {
+  for (char *ptr = out + 9; ptr != out + 1; ptr -= 2) {
+    std::memcpy(ptr - 2, DIGIT_PAIRS + 2 * (limb % 100), 2);
+    limb /= 100;
+  }
+  out[0] = static_cast<char>('0' + limb);
+}
+
+constexpr uint64_t ASCII_ZEROES = 0x3030303030303030;
+
+bool is_space(char chr) {
+  return chr == ' ' || (chr >= '\t' && chr <= '\r');
+}
+
+// Non-zero unless all eight bytes of the chunk are decimal digits.
+uint64_t invalid_chunk(uint64_t chunk) {
+  return ((chunk & 0xF0F0F0F0F0F0F0F0) | (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ^ 0x3333333333333333;
+}
+
+uint64_t load_chunk(const char *ptr) {
+  uint64_t chunk;
+  std::memcpy(&chunk, ptr, 8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  chunk = __builtin_bswap64(chunk);
+#endif
+  return chunk;
+}
+
+// Value of the eight digits in a validated chunk, first character most significant.
+uint32_t parse_chunk(uint64_t chunk) {
+  chunk -= ASCII_ZEROES;
+  chunk = (chunk * 10 + (chunk >> 8)) & 0x00FF00FF00FF00FF;
+  chunk = (chunk * 100 + (chunk >> 16)) & 0x0000FFFF0000FFFF;
+  chunk = (chunk * 10000 + (chunk >> 32)) & 0x00000000FFFFFFFF;
+
+  return static_cast<uint32_t>(chunk);
+}
+
+// The digits of the number with the given little endian nine digit chunks, size non-zero and the top chunk non-zero.
+// The top chunk is printed without padding, every other chunk takes exactly nine characters, so the length is
+// known up front and the digits go straight into the result.
+std::string write_chunks(const Limb *chunks, size_t size, bool positive) {
+  char top[9];
+  write_limb(top, chunks[size - 1]);
+
+  size_t skip = 0;
+  while (top[skip] == '0') {
+    ++skip;
+  }
+
+  const size_t sign = positive ? 0 : 1;
+  std::string result(sign + 9 - skip + 9 * (size - 1), '-');
+
+  char *out = std::copy(top + skip, top + 9, result.data() + sign);
+  for (size_t idx = size - 1; idx-- > 0; out += 9) {
+    write_limb(out, chunks[idx]);
+  }
+
+  return result;
+}
+
+}// namespace
+
+// Conversion between nine digit chunks, the decimal text, and binary limbs. Both directions split the number at
+// 10^(9 * DECIMAL_BASECASE * 2^i), so the cost is that of the multiplications and divisions by those powers
+// rather than quadratic in the size. Only used with binary limbs, decimal limbs already are the chunks.
+struct Decimal {
+  using Chunks = std::vector<Limb>;
+
+  std::vector<Bigint> powers;// powers[i] = 10^(9 * DECIMAL_BASECASE << i)
+
+  explicit Decimal(const Bigint::allocator_type &allocator) {
+    Bigint first(CHUNK, allocator);
+    first.pow(DECIMAL_BASECASE);
+    powers.push_back(std::move(first));
+  }
+
+  const Bigint &power(size_t level) {
+    while (powers.size() <= level) {
+      Bigint next(powers.back());
+      powers.push_back(std::move(next.square()));
+    }
+
+    return powers[level];
+  }
+
+  // Chunks of |x|, which has size limbs without leading zeros, and no leading zero chunks
+  Chunks to_chunks(const Bigint &x, size_t size) {
+    size_t level = 0;
+    while (limbs::compare(x.number.begin(), size, power(level).number.begin(), power(level).number.size()) >= 0) {
+      ++level;
+    }
+
+    Chunks chunks(DECIMAL_BASECASE << level);
+    Bigint magnitude(x);
+    split(magnitude.abs(), level, chunks.data());
+    while (!chunks.empty() && chunks.back() == 0) {
+      chunks.pop_back();
+    }
+
+    return chunks;
+  }
+
+  // out[0, DECIMAL_BASECASE << level) = chunks of x, for 0 <= x < 10^(9 * DECIMAL_BASECASE << level)
+  void split(const Bigint &x, size_t level, Limb *out) {
+    size_t size = x.number.size();
+    while (size > 0 && x.number[size - 1] == 0) {
+      --size;
+    }
+
+    if (level == 0) {
+      Chunks digits(x.number.begin(), x.number.begin() + size);
+      for (size_t i = 0; !digits.empty(); ++i) {
+        out[i] = static_cast<Limb>(limbs::div_1(digits.data(), digits.size(), CHUNK));
+        while (!digits.empty() && digits.back() == 0) {
+          digits.pop_back();
+        }
+      }
+      return;
+    }
+
+    if (size < power(level - 1).number.size()) {
+      split(x, level - 1, out);
+      return;
+    }
+    auto [high, low] = divmod(x, power(level - 1));
+    split(low, level - 1, out);
+    split(high, level - 1, out + (DECIMAL_BASECASE << (level - 1)));
+  }
+
+  // The non-negative number with the given chunks
+  Bigint from_chunks(const Limb *chunks, size_t size, const Bigint::allocator_type &allocator) {
+    size_t level = 0;
+    while ((DECIMAL_BASECASE << level) < size) {
+      ++level;
+    }
+
+    Chunks padded(chunks, chunks + size);
+    padded.resize(DECIMAL_BASECASE << level);
+    return join(padded.data(), level, allocator);
+  }
+
+  Bigint join(const Limb *chunks, size_t level, const Bigint::allocator_type &allocator) {
+    const size_t count = DECIMAL_BASECASE << level;
+    if (level == 0) {
+      // A chunk of 29.9 bits never takes more than a limb
+      Bigint result(allocator);
+      result.number.resize(count);
+      Limb *ptr = result.number.begin();
+      size_t used = 0;
+      for (size_t i = count; i-- > 0;) {
+        const uint32_t carry = limbs::mul_1(ptr, used, CHUNK);
+        if (carry != 0) {
+          ptr[used++] = static_cast<Limb>(carry);
+        }
+        uint64_t chunk = chunks[i];
+        for (size_t j = 0; chunk != 0; ++j) {
+          if (j == used) {
+            ptr[used++] = 0;
+          }
+          const uint64_t sum = ptr[j] + chunk;
+          chunk = sum >= limbs::BASE ? 1 : 0;
+          ptr[j] = static_cast<Limb>(sum - chunk * limbs::BASE);
+        }
+      }
+      while (!result.number.empty() && result.number.back() == 0) {
+        result.number.pop_back();
+      }
+
+      return result;
+    }
+
+    const size_t half = count / 2;
+    Bigint result = join(chunks, level - 1, allocator);
+    if (std::any_of(chunks + half, chunks + count, [](Limb chunk) { return chunk != 0; })) {
+      result.addmul(join(chunks + half, level - 1, allocator), power(level - 1));
+    }
+
+    return result;
+  }
+};
+
+Bigint::Bigint(std::string_view string) : Bigint(string, allocator_type()) {}
+
+Bigint::Bigint(std::string_view string, const allocator_type &allocator) : number(allocator.resource()) {
+  const char *first = string.data();
+  const char *last = first + string.size();
+
+  while (first != last && is_space(*first)) {
+    ++first;
+  }
+  while (first != last && is_space(last[-1])) {
+    --last;
+  }
+
+  if (first != last && (*first == '+' || *first == '-')) {
+    positive = *first++ == '+';
+  }
+  if (first == last) {
+    throw std::invalid_argument("Not a valid integer");
+  }
+
+  while (last - first > 1 && *first == '0') {
+    ++first;
+  }
+
+  const auto length = static_cast<size_t>(last - first);
+  number.resize((length + 8) / 9);
+
+  // Digits are only checked here and reported once the whole string has been read. The limbs are filled with
+  // nine digit chunks, converted afterwards when the limbs are binary.
+  uint64_t invalid = 0;
+  Limb *limb = number.begin();
+
+  for (; last - first >= 9; last -= 9) {
+    const char *ptr = last - 9;
+    const uint64_t chunk = load_chunk(ptr + 1);
+
+    invalid |= invalid_chunk(chunk) | (static_cast<unsigned char>(*ptr - '0') > 9);
+    *limb++ = static_cast<Limb>((*ptr - '0') * 100000000u + parse_chunk(chunk));
+  }
+
+  if (first != last) {
+    uint32_t value = 0;
+    for (const char *ptr = first; ptr != last; ++ptr) {
+      invalid |= static_cast<unsigned char>(*ptr - '0') > 9;
+      value = value * 10 + static_cast<unsigned char>(*ptr - '0');
+    }
+    *limb = static_cast<Limb>(value);
+  }
+
+  if (invalid != 0) {
+    throw std::invalid_argument("Not a valid integer");
+  }
+
+  if (number.back() == 0) {
+    number.clear();
+    positive = true;
+  } else if constexpr (limbs::BINARY) {
+    Decimal decimal(allocator);
+    number = std::move(decimal.from_chunks(number.begin(), number.size(), allocator).number);
+  }
+}
+
+std::string Bigint::to_string() const {
+  size_t size = number.size();
+  while (size > 0 && number[size - 1] == 0) {
+    --size;
+  }
+
+  if (size == 0) {
+    return "0";
+  }
+
+  if constexpr (limbs::BINARY) {
+    Decimal decimal(get_allocator());
+    const Decimal::Chunks chunks = decimal.to_chunks(*this, size);
+    return write_chunks(chunks.data(), chunks.size(), positive);
+  }
+
+  return write_chunks(number.begin(), size, positive);
+}
+
+std::istream &operator>>(std::istream &stream, Bigint &bigint) {
+  std::string string;
+
+  if (stream >> string) {
+    bigint = Bigint(string);
+  }
+
+  return stream;
+}
+
+std::ostream &operator<<(std::ostream &stream, const Bigint &bigint) {
+  return stream << bigint.to_string();
+}
+
+std::string to_string(const Bigint &bigint) {
+  return bigint.to_string();
+}
+
+}// namespace BigMath
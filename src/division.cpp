@@ -0,0 +1,300 @@
+#include "bigint.h"
+#include "limbs.h"
+
+namespace BigMath {
+
+namespace limbs {
+
+namespace {
+
+// Divisor and quotient size (in limbs) from which Burnikel-Ziegler beats Algorithm D.
+constexpr size_t BURNIKEL_ZIEGLER_THRESHOLD = 50;
+
+// Knuth's Algorithm D (TAOCP vol. 2, 4.3.1).
+// quotient[0, left_size - right_size + 1) = left / right, remainder[0, right_size) = left % right.
+// Requires right_size >= 2, left_size >= right_size and a non-zero top limb in right.
+void div_knuth(Limb *quotient, Limb *remainder, const Limb *left, size_t left_size, const Limb *right, size_t right_size) {
+  // D1: scale both operands so the divisor's top limb is at least BASE / 2.
+  const auto scale = static_cast<uint32_t>(BASE / (static_cast<uint64_t>(right[right_size - 1]) + 1));
+
+  SmallVector<Limb> dividend(left, left_size);
+  SmallVector<Limb> divisor(right, right_size);
+
+  dividend.push_back(static_cast<Limb>(mul_1(dividend.begin(), left_size, scale)));
+  mul_1(divisor.begin(), right_size, scale);
+
+  const uint64_t divisor_top = static_cast<uint32_t>(divisor[right_size - 1]);
+  const uint64_t divisor_next = static_cast<uint32_t>(divisor[right_size - 2]);
+
+  for (size_t shift = left_size - right_size + 1; shift > 0; --shift) {
+    Limb *window = dividend.begin() + shift - 1;
+
+    // D3: estimate the quotient limb from the top two limbs, then correct it with the third.
+    const uint64_t top = static_cast<uint64_t>(static_cast<uint32_t>(window[right_size])) * BASE + static_cast<uint32_t>(window[right_size - 1]);
+    uint64_t estimate = top / divisor_top;
+    uint64_t rest = top % divisor_top;
+
+    while (estimate >= BASE || estimate * divisor_next > rest * BASE + static_cast<uint32_t>(window[right_size - 2])) {
+      --estimate;
+      rest += divisor_top;
+      if (rest >= BASE) {
+        break;
+      }
+    }
+
+    // D4: window[0, right_size] -= estimate * divisor.
+    const int64_t top_diff = window[right_size] - static_cast<int64_t>(submul_1(window, divisor.begin(), right_size, static_cast<uint32_t>(estimate)));
+
+    // D6: the estimate was one too large, add the divisor back.
+    if (top_diff < 0) {
+      --estimate;
+
+      add_in_place(window, right_size, divisor.begin(), right_size);
+    }
+    window[right_size] = 0;
+
+    quotient[shift - 1] = static_cast<Limb>(estimate);
+  }
+
+  // D8: unscale the remainder.
+  div_1(dividend.begin(), right_size, scale);
+  std::copy(dividend.begin(), dividend.begin() + right_size, remainder);
+}
+
+
+void div_2n1n(Limb *quotient, Limb *remainder, const Limb *left, const Limb *right, size_t size);
+
+// Burnikel-Ziegler 3n/2n step. quotient[0, half) and remainder[0, 2 * half) of left[0, 3 * half) by
+// right[0, 2 * half), for a normalized right and left < right * BASE^half.
+void div_3n2n(Limb *quotient, Limb *remainder, const Limb *left, const Limb *right, size_t half) {
+  const Limb *right_high = right + half;
+  // rest = r1 * BASE^half + left_low, with room for adding right back while it is below the correction.
+  const size_t rest_size = 2 * half + 2;
+  SmallVector<Limb> rest(rest_size);
+
+  std::copy(left, left + half, rest.begin());
+
+  if (compare(left + 2 * half, half, right_high, half) < 0) {
+    div_2n1n(quotient, rest.begin() + half, left + half, right_high, half);
+  } else {
+    // The quotient estimate saturates at BASE^half - 1, so r1 = left_high - right_high * BASE^half + right_high.
+    std::fill(quotient, quotient + half, static_cast<Limb>(BASE - 1));
+    SmallVector<Limb> high(2 * half + 1);
+
+    std::copy(left + half, left + 3 * half, high.begin());
+    sub_in_place(high.begin() + half, half + 1, right_high, half);
+    add_in_place(high.begin(), 2 * half + 1, right_high, half);
+    std::copy(high.begin(), high.begin() + half + 1, rest.begin() + half);
+  }
+
+  // correction = quotient * right_low, then rest -= correction with at most two add-backs of right.
+  SmallVector<Limb> correction(2 * half);
+  const Limb one = 1;
+
+  mul(correction.begin(), quotient, half, right, half);
+
+  while (compare(rest.begin(), rest_size, correction.begin(), 2 * half) < 0) {
+    add_in_place(rest.begin(), rest_size, right, 2 * half);
+    sub_in_place(quotient, half, &one, 1);
+  }
+
+  sub_in_place(rest.begin(), rest_size, correction.begin(), 2 * half);
+  std::copy(rest.begin(), rest.begin() + 2 * half, remainder);
+}
+
+// Burnikel-Ziegler 2n/1n step. quotient[0, size) and remainder[0, size) of left[0, 2 * size) by right[0, size),
+// for a normalized right and left < right * BASE^size.
+void div_2n1n(Limb *quotient, Limb *remainder, const Limb *left, const Limb *right, size_t size) {
+  if (size % 2 != 0 || size < BURNIKEL_ZIEGLER_THRESHOLD) {
+    SmallVector<Limb> full_quotient(size + 1);
+
+    div_knuth(full_quotient.begin(), remainder, left, 2 * size, right, size);
+    std::copy(full_quotient.begin(), full_quotient.begin() + size, quotient);
+
+    return;
+  }
+
+  const size_t half = size / 2;
+  SmallVector<Limb> middle(3 * half);
+
+  std::copy(left, left + half, middle.begin());
+  div_3n2n(quotient + half, middle.begin() + half, left + half, right, half);
+  div_3n2n(quotient, remainder, middle.begin(), right, half);
+}
+
+// Burnikel and Ziegler, "Fast Recursive Division" (1998): the dividend is cut into blocks of the padded divisor
+// size and divided block by block with the recursive 2n/1n step, whose products go through mul.
+void div_burnikel_ziegler(Limb *quotient, Limb *remainder, const Limb *left, size_t left_size, const Limb *right, size_t right_size) {
+  // Pad the divisor to block * 2^levels limbs so every recursion level halves evenly down to Algorithm D.
+  size_t size = right_size;
+  size_t levels = 0;
+
+  while (size >= BURNIKEL_ZIEGLER_THRESHOLD) {
+    size = (size + 1) / 2;
+    ++levels;
+  }
+  size <<= levels;
+
+  const size_t shift = size - right_size;
+  const auto scale = static_cast<uint32_t>(BASE / (static_cast<uint64_t>(right[right_size - 1]) + 1));
+
+  // The top block is kept below BASE^(size - 1), hence below the normalized divisor.
+  const size_t blocks = (left_size + shift + 2 + size - 1) / size;
+
+  SmallVector<Limb> divisor(size);
+  SmallVector<Limb> dividend(blocks * size);
+
+  std::copy(right, right + right_size, divisor.begin() + shift);
+  mul_1(divisor.begin() + shift, right_size, scale);
+  std::copy(left, left + left_size, dividend.begin() + shift);
+  dividend[shift + left_size] = static_cast<Limb>(mul_1(dividend.begin() + shift, left_size, scale));
+
+  SmallVector<Limb> full_quotient((blocks - 1) * size);
+  SmallVector<Limb> window(2 * size);
+
+  std::copy(dividend.begin() + (blocks - 1) * size, dividend.begin() + blocks * size, window.begin() + size);
+
+  for (size_t block = blocks - 1; block > 0; --block) {
+    std::copy(dividend.begin() + (block - 1) * size, dividend.begin() + block * size, window.begin());
+    div_2n1n(full_quotient.begin() + (block - 1) * size, window.begin() + size, window.begin(), divisor.begin(), size);
+  }
+
+  std::copy(full_quotient.begin(), full_quotient.begin() + left_size - right_size + 1, quotient);
+  div_1(window.begin() + size + shift, right_size, scale);
+  std::copy(window.begin() + size + shift, window.begin() + 2 * size, remainder);
+}
+
+}// namespace
+
+void divmod(Limb *quotient, Limb *remainder, const Limb *left, size_t left_size, const Limb *right, size_t right_size) {
+  if (right_size == 1) {
+    std::copy(left, left + left_size, quotient);
+    remainder[0] = static_cast<Limb>(div_1(quotient, left_size, static_cast<uint32_t>(right[0])));
+  } else if (right_size < BURNIKEL_ZIEGLER_THRESHOLD || left_size - right_size < BURNIKEL_ZIEGLER_THRESHOLD) {
+    div_knuth(quotient, remainder, left, left_size, right, right_size);
+  } else {
+    div_burnikel_ziegler(quotient, remainder, left, left_size, right, right_size);
+  }
+}
+
+}// namespace limbs
+
+Bigint Bigint::operator/(const Bigint &right) const {
+  return divmod(*this, right).first;
+}
+
+Bigint &Bigint::operator/=(const Bigint &right) {
+  *this = divmod(*this, right).first;
+
+  return *this;
+}
+
+Bigint Bigint::operator%(const Bigint &right) const {
+  return divmod(*this, right).second;
+}
+
+Bigint &Bigint::operator%=(const Bigint &right) {
+  *this = divmod(*this, right).second;
+
+  return *this;
+}
+
+std::pair<Bigint, Bigint> divmod(const Bigint &left, const Bigint &right) {
+  if (right == Bigint()) {
+    throw std::invalid_argument("Divisor must be non zero");
+  }
+
+  size_t left_size = left.number.size();
+  size_t right_size = right.number.size();
+
+  while (left_size > 0 && left.number[left_size - 1] == 0) {
+    --left_size;
+  }
+  while (right.number[right_size - 1] == 0) {
+    --right_size;
+  }
+
+  if (left_size < right_size) {
+    return { Bigint(left.get_allocator()), left };
+  }
+
+  Bigint quotient(left.get_allocator());
+  Bigint remainder(left.get_allocator());
+
+  quotient.number.resize(left_size - right_size + 1);
+  remainder.number.resize(right_size);
+
+  limbs::divmod(quotient.number.begin(), remainder.number.begin(), left.number.begin(), left_size, right.number.begin(), right_size);
+
+  while (!quotient.number.empty() && quotient.number.back() == 0) {
+    quotient.number.pop_back();
+  }
+  while (!remainder.number.empty() && remainder.number.back() == 0) {
+    remainder.number.pop_back();
+  }
+
+  // Truncated division: the quotient rounds toward zero and the remainder takes the sign of the dividend.
+  quotient.positive = quotient.number.empty() || left.positive == right.positive;
+  remainder.positive = remainder.number.empty() || left.positive;
+
+  return { std::move(quotient), std::move(remainder) };
+}
+
+// Remainder tree: the moduli are multiplied pairwise up to a single product, then value is reduced down the tree,
+// each node taking its parent's remainder modulo its own product. The bottom nodes cover REMAINDER_TREE_LEAF
+// moduli, which are reduced word by word from a remainder of a few limbs.
+std::vector<int64_t> remainders(const Bigint &value, const std::vector<int64_t> &moduli) {
+  constexpr size_t REMAINDER_TREE_LEAF = 8;
+
+  if (std::find(moduli.begin(), moduli.end(), 0) != moduli.end()) {
+    throw std::invalid_argument("Divisor must be non zero");
+  }
+  if (moduli.empty()) {
+    return {};
+  }
+
+  std::vector<std::vector<Bigint>> tree(1);
+  for (size_t begin = 0; begin < moduli.size(); begin += REMAINDER_TREE_LEAF) {
+    Bigint product(1, value.get_allocator());
+    for (size_t i = begin; i < std::min(begin + REMAINDER_TREE_LEAF, moduli.size()); ++i) {
+      product *= moduli[i];
+    }
+    tree[0].push_back(std::move(product.abs()));
+  }
+  while (tree.back().size() > 1) {
+    const std::vector<Bigint> &below = tree.back();
+    std::vector<Bigint> level;
+    level.reserve((below.size() + 1) / 2);
+    for (size_t i = 0; i + 1 < below.size(); i += 2) {
+      level.push_back(below[i] * below[i + 1]);
+    }
+    if (below.size() % 2 != 0) {
+      level.push_back(below.back());
+    }
+    tree.push_back(std::move(level));
+  }
+
+  Bigint magnitude = value;
+  std::vector<Bigint> reduced;
+  reduced.push_back(magnitude.abs() % tree.back()[0]);
+  for (size_t level = tree.size() - 1; level > 0; --level) {
+    std::vector<Bigint> next;
+    next.reserve(tree[level - 1].size());
+    for (size_t i = 0; i < tree[level - 1].size(); ++i) {
+      next.push_back(reduced[i / 2] % tree[level - 1][i]);
+    }
+    reduced = std::move(next);
+  }
+
+  std::vector<int64_t> result(moduli.size());
+  for (size_t i = 0; i < moduli.size(); ++i) {
+    result[i] = reduced[i / REMAINDER_TREE_LEAF] % moduli[i];
+    if (value.is_negative()) {
+      result[i] = -result[i];
+    }
+  }
+
+  return result;
+}
+
+}// namespace BigMath
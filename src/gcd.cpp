@@ -0,0 +1,354 @@
+#include "bigint.h"
+#include "limbs.h"
+
+#include <stdexcept>
+
+namespace BigMath {
+
+namespace {
+
+// Size (in limbs) of the larger operand from which the half-gcd recursion beats Lehmer's algorithm.
+constexpr size_t HALF_GCD_THRESHOLD = 160;
+
+constexpr std::array<uint64_t, 19> POW10_64 = { 1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+  100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+  1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL };
+
+}// namespace
+
+// Euclidean reductions behind gcd, extended_gcd and mod_inverse. Every step maps the pair (a, b) through a
+// matrix of determinant +-1, so the gcd is preserved whatever the steps are. Lehmer's algorithm and the half-gcd
+// recursion only decide how many limbs each step removes.
+struct Euclid {
+  // (x; y) <- [[a00, a01], [a10, a11]] (x; y) from Lehmer's algorithm, or (x; y) <- (y; x - quotient * y)
+  struct Step {
+    int64_t a00 = 1;
+    int64_t a01 = 0;
+    int64_t a10 = 0;
+    int64_t a11 = 1;
+    bool division = false;
+    Bigint quotient;
+  };
+
+  // (x; y) <- [[m00, m01], [m10, m11]] (x; y), the product of the steps taken
+  struct Matrix {
+    Bigint m00 = 1;
+    Bigint m01 = 0;
+    Bigint m10 = 0;
+    Bigint m11 = 1;
+
+    void apply_to(Bigint &x, Bigint &y) const {
+      Bigint next_x = m00 * x;
+      next_x.addmul(m01, y);
+      Bigint next_y = m10 * x;
+      next_y.addmul(m11, y);
+
+      x = std::move(next_x);
+      y = std::move(next_y);
+    }
+
+    void push(const Step &step) {// this <- step * this
+      apply(step, m00, m10);
+      apply(step, m01, m11);
+    }
+
+    void push(const Matrix &step) {// this <- step * this
+      step.apply_to(m00, m10);
+      step.apply_to(m01, m11);
+    }
+  };
+
+  static void apply(const Step &step, Bigint &x, Bigint &y) {
+    if (step.division) {
+      x.submul(step.quotient, y);
+      std::swap(x, y);
+      return;
+    }
+
+    Bigint next_x(x.get_allocator());
+    next_x.addmul_1(x, step.a00).addmul_1(y, step.a01);
+    Bigint next_y(x.get_allocator());
+    next_y.addmul_1(x, step.a10).addmul_1(y, step.a11);
+
+    x = std::move(next_x);
+    y = std::move(next_y);
+  }
+
+  static size_t size(const Bigint &x) {
+    size_t limbs = x.number.size();
+    while (limbs > 0 && x.number[limbs - 1] == 0) {
+      --limbs;
+    }
+
+    return limbs;
+  }
+
+  static bool less(const Bigint &x, const Bigint &y) {
+    return limbs::compare(x.number.begin(), size(x), y.number.begin(), size(y)) < 0;
+  }
+
+  static void negate(Bigint &x) {
+    x.positive = !x.positive || size(x) == 0;
+  }
+
+  // floor(|x| / BASE^from)
+  static Bigint high(const Bigint &x, size_t from) {
+    Bigint result(x.get_allocator());
+    const size_t limbs = size(x);
+    if (limbs > from) {
+      result.number.resize(limbs - from);
+      std::copy(x.number.begin() + from, x.number.begin() + limbs, result.number.begin());
+    }
+
+    return result;
+  }
+
+  // Makes a and b non-negative with a >= b, doing the same to the rows of matrix.
+  static void normalize(Bigint &a, Bigint &b, Matrix &matrix) {
+    if (!a.positive) {
+      a.positive = true;
+      negate(matrix.m00);
+      negate(matrix.m01);
+    }
+    if (!b.positive) {
+      b.positive = true;
+      negate(matrix.m10);
+      negate(matrix.m11);
+    }
+    if (less(a, b)) {
+      std::swap(a, b);
+      std::swap(matrix.m00, matrix.m10);
+      std::swap(matrix.m01, matrix.m11);
+    }
+  }
+
+  // One Lehmer step on a >= b > 0. The quotients are taken from the leading 18 digits (60 bits) of both numbers for as
+  // long as they are certain (Knuth's algorithm L), and a single division replaces the step when not even one is.
+  static Step lehmer_step(Bigint &a, Bigint &b) {
+    const size_t a_size = size(a);
+    const size_t b_size = size(b);
+    const auto limb = [](const Bigint &x, size_t limbs, size_t index) -> uint64_t {
+      return index < limbs ? static_cast<uint32_t>(x.number[index]) : 0;
+    };
+
+    Step step;
+    uint64_t a_hat = 0;
+    uint64_t b_hat = 0;
+    if (a_size <= 2) {
+      a_hat = limb(a, a_size, 1) * limbs::BASE + limb(a, a_size, 0);
+      b_hat = limb(b, b_size, 1) * limbs::BASE + limb(b, b_size, 0);
+
+      // Both numbers fit in a word, so this runs Euclid to the end.
+      while (b_hat != 0) {
+        const auto quotient = static_cast<int64_t>(a_hat / b_hat);
+        const int64_t a10 = step.a00 - quotient * step.a10;
+        const int64_t a11 = step.a01 - quotient * step.a11;
+        step = { step.a10, step.a11, a10, a11, false, Bigint() };
+
+        const uint64_t remainder = a_hat % b_hat;
+        a_hat = b_hat;
+        b_hat = remainder;
+      }
+    } else {
+      // floor(a / 10^k) and floor(b / 10^k) with k chosen so that the first has exactly 18 digits, or for binary
+      // limbs floor(a / 2^k) and floor(b / 2^k) with the first of exactly 60 bits
+      uint32_t top_digits = 0;
+      for (uint64_t top = limb(a, a_size, a_size - 1); top != 0; top = limbs::BINARY ? top >> 1U : top / 10) {
+        ++top_digits;
+      }
+      const auto truncate = [&](const Bigint &x, size_t limbs) -> uint64_t {
+        if constexpr (limbs::BINARY) {
+          const uint64_t high = limb(x, limbs, a_size - 1) << 32U | limb(x, limbs, a_size - 2);
+          return top_digits <= 28 ? high << (28 - top_digits) | limb(x, limbs, a_size - 3) >> (top_digits + 4)
+                                  : high >> (top_digits - 28);
+        }
+        return limb(x, limbs, a_size - 1) * POW10_64[18 - top_digits] + limb(x, limbs, a_size - 2) * POW10_64[9 - top_digits]
+               + limb(x, limbs, a_size - 3) / POW10_64[top_digits];
+      };
+      auto x = static_cast<int64_t>(truncate(a, a_size));
+      auto y = static_cast<int64_t>(truncate(b, b_size));
+
+      while (y + step.a10 > 0 && y + step.a11 > 0) {
+        const int64_t quotient = (x + step.a00) / (y + step.a10);
+        if (quotient != (x + step.a01) / (y + step.a11)) {
+          break;
+        }
+
+        const int64_t a10 = step.a00 - quotient * step.a10;
+        const int64_t a11 = step.a01 - quotient * step.a11;
+        step = { step.a10, step.a11, a10, a11, false, Bigint() };
+
+        const int64_t remainder = x - quotient * y;
+        x = y;
+        y = remainder;
+      }
+
+      if (step.a01 == 0) {
+        auto [quotient, remainder] = divmod(a, b);
+        a = std::move(b);
+        b = std::move(remainder);
+
+        step.division = true;
+        step.quotient = std::move(quotient);
+        return step;
+      }
+    }
+
+    apply(step, a, b);
+
+    return step;
+  }
+
+  // Reduces a >= b >= 0 until b has at most half the limbs of a, plus one. The top half of the pair is reduced first
+  // by a recursive call and its matrix applied to the whole pair, then the same is done once more on what is left.
+  // When matrix is given it must be the identity, and on return (a; b) = matrix (a_in; b_in).
+  static void half_gcd(Bigint &a, Bigint &b, Matrix *matrix) {
+    const size_t a_size = size(a);
+    const size_t stop = a_size / 2 + 1;
+
+    if (a_size >= HALF_GCD_THRESHOLD && size(b) > stop) {
+      const size_t split = a_size / 2;
+      Matrix first;
+      Bigint a_high = high(a, split);
+      Bigint b_high = high(b, split);
+      half_gcd(a_high, b_high, &first);
+
+      first.apply_to(a, b);
+      normalize(a, b, first);
+      if (matrix != nullptr) {
+        *matrix = std::move(first);
+      }
+
+      const size_t reduced_size = size(a);
+      if (size(b) > stop && 2 * stop > reduced_size) {
+        const size_t second_split = std::min(2 * stop - reduced_size, reduced_size);
+        Matrix second;
+        a_high = high(a, second_split);
+        b_high = high(b, second_split);
+        half_gcd(a_high, b_high, &second);
+
+        second.apply_to(a, b);
+        normalize(a, b, second);
+        if (matrix != nullptr) {
+          matrix->push(second);
+        }
+      }
+    }
+
+    while (size(b) > stop) {
+      const Step step = lehmer_step(a, b);
+      if (matrix != nullptr) {
+        matrix->push(step);
+      }
+    }
+  }
+
+  // Runs a >= b >= 0 down to (gcd, 0). When given, u and v go through the same steps as a and b.
+  static void reduce(Bigint &a, Bigint &b, Bigint *u, Bigint *v) {
+    while (size(b) != 0) {
+      const size_t a_size = size(a);
+      if (a_size >= HALF_GCD_THRESHOLD && size(b) > a_size / 2 + 1) {
+        Matrix matrix;
+        half_gcd(a, b, u != nullptr ? &matrix : nullptr);
+        if (u != nullptr) {
+          matrix.apply_to(*u, *v);
+        }
+      } else {
+        const Step step = lehmer_step(a, b);
+        if (u != nullptr) {
+          apply(step, *u, *v);
+        }
+      }
+    }
+    a.positive = true;
+  }
+};
+
+Bigint gcd(const Bigint &left, const Bigint &right) {
+  Bigint a(left);
+  Bigint b(right, left.get_allocator());
+  a.abs();
+  b.abs();
+  if (Euclid::less(a, b)) {
+    std::swap(a, b);
+  }
+
+  Euclid::reduce(a, b, nullptr, nullptr);
+
+  return a;
+}
+
+Bigint lcm(const Bigint &left, const Bigint &right) {
+  if (Euclid::size(left) == 0 || Euclid::size(right) == 0) {
+    return Bigint(left.get_allocator());
+  }
+
+  Bigint result = left / gcd(left, right) * right;
+
+  return result.abs();
+}
+
+std::tuple<Bigint, Bigint, Bigint> extended_gcd(const Bigint &left, const Bigint &right) {
+  Bigint a(left);
+  Bigint b(right, left.get_allocator());
+  a.abs();
+  b.abs();
+
+  // u and v hold the coefficient of |left| in a and b
+  Bigint u(1, left.get_allocator());
+  Bigint v(left.get_allocator());
+  if (Euclid::less(a, b)) {
+    std::swap(a, b);
+    std::swap(u, v);
+  }
+
+  Euclid::reduce(a, b, &u, &v);
+
+  if (Euclid::size(right) == 0) {
+    return { std::move(a), Bigint(Euclid::size(left) == 0 ? 0 : left.is_negative() ? -1 : 1), Bigint() };
+  }
+
+  // Smallest non-negative x, then y from x * left + y * right = g.
+  Bigint cofactor_range = right / a;
+  cofactor_range.abs();
+  if (left.is_negative()) {
+    Euclid::negate(u);
+  }
+  Bigint x = u % cofactor_range;
+  if (x.is_negative()) {
+    x += cofactor_range;
+  }
+  Bigint y = (a - x * left) / right;
+
+  return { std::move(a), std::move(x), std::move(y) };
+}
+
+Bigint mod_inverse(const Bigint &value, const Bigint &modulus) {
+  if (modulus.is_negative() || Euclid::size(modulus) == 0) {
+    throw std::invalid_argument("Modulus must be positive");
+  }
+
+  // u and v hold the coefficient of value in a and b
+  Bigint a(modulus, value.get_allocator());
+  Bigint b = value % modulus;
+  if (b.is_negative()) {
+    b += modulus;
+  }
+  Bigint u(value.get_allocator());
+  Bigint v(1, value.get_allocator());
+
+  Euclid::reduce(a, b, &u, &v);
+
+  if (a != Bigint(1)) {
+    throw std::invalid_argument("Value is not invertible");
+  }
+
+  u %= modulus;
+  if (u.is_negative()) {
+    u += modulus;
+  }
+
+  return u;
+}
+
+}// namespace BigMath
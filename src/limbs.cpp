@@ -0,0 +1,265 @@
+#include "limbs.h"
+
+namespace BigMath::limbs {
+
+namespace {
+
+struct Kernels {
+  uint32_t (*add)(Limb *, const Limb *, size_t, uint32_t);
+  uint32_t (*sub)(Limb *, const Limb *, size_t, uint32_t);
+};
+
+Kernels select_kernels() {
+#ifdef BIGINT_X86_KERNELS
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return { add_n_avx512, sub_n_avx512 };
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return { add_n_avx2, sub_n_avx2 };
+  }
+#endif
+  return { add_n, sub_n };
+}
+
+const Kernels &kernels() {
+  static const Kernels selected = select_kernels();
+
+  return selected;
+}
+
+struct Wide {
+  uint64_t high;
+  uint64_t low;
+};
+
+#ifdef __SIZEOF_INT128__
+__extension__ typedef unsigned __int128 uint128_t;
+
+Wide mul_wide(uint64_t left, uint64_t right) {
+  const uint128_t product = static_cast<uint128_t>(left) * right;
+
+  return { static_cast<uint64_t>(product >> 64U), static_cast<uint64_t>(product) };
+}
+
+// (high * 2^64 + low) / divisor for high < divisor.
+uint64_t div_wide(uint64_t high, uint64_t low, uint64_t divisor) {
+  return static_cast<uint64_t>(((static_cast<uint128_t>(high) << 64U) | low) / divisor);
+}
+#else
+Wide mul_wide(uint64_t left, uint64_t right) {
+  const uint64_t left_low = left & 0xFFFFFFFFU;
+  const uint64_t left_high = left >> 32U;
+  const uint64_t right_low = right & 0xFFFFFFFFU;
+  const uint64_t right_high = right >> 32U;
+
+  const uint64_t low_low = left_low * right_low;
+  const uint64_t middle = (low_low >> 32U) + (left_high * right_low & 0xFFFFFFFFU) + left_low * right_high;
+
+  return { left_high * right_high + (left_high * right_low >> 32U) + (middle >> 32U), (middle << 32U) | (low_low & 0xFFFFFFFFU) };
+}
+
+// (high * 2^64 + low) / divisor for high < divisor, one quotient bit at a time. Only used once per Divisor.
+uint64_t div_wide(uint64_t high, uint64_t low, uint64_t divisor) {
+  uint64_t quotient = 0;
+  for (int32_t bit = 63; bit >= 0; --bit) {
+    const bool overflow = (high >> 63U) != 0;
+    high = (high << 1U) | (low >> 63U);
+    low <<= 1U;
+    quotient <<= 1U;
+    if (overflow || high >= divisor) {
+      high -= divisor;
+      quotient |= 1U;
+    }
+  }
+
+  return quotient;
+}
+#endif
+
+// (high * 2^64 + low) mod divisor.normalized for high < divisor.normalized.
+uint64_t rem_wide(uint64_t high, uint64_t low, const Divisor &divisor) {
+  Wide quotient = mul_wide(divisor.reciprocal, high);
+  quotient.low += low;
+  quotient.high += high + 1 + (quotient.low < low ? 1 : 0);
+
+  uint64_t remainder = low - quotient.high * divisor.normalized;
+  if (remainder > quotient.low) {
+    remainder += divisor.normalized;
+  }
+  if (remainder >= divisor.normalized) {
+    remainder -= divisor.normalized;
+  }
+
+  return remainder;
+}
+
+}// namespace
+
+uint32_t add_n(Limb *left, const Limb *right, size_t size, uint32_t carry) {
+  for (size_t idx = 0; idx < size; ++idx) {
+    const uint64_t sum = uint64_t{ static_cast<uint32_t>(left[idx]) } + static_cast<uint32_t>(right[idx]) + carry;
+    carry = sum >= BASE ? 1 : 0;
+    left[idx] = static_cast<Limb>(carry != 0 ? sum - BASE : sum);
+  }
+
+  return carry;
+}
+
+uint32_t sub_n(Limb *left, const Limb *right, size_t size, uint32_t borrow) {
+  // A negative difference wraps around 2^64, and adding BASE wraps it back to the limb
+  for (size_t idx = 0; idx < size; ++idx) {
+    const uint64_t diff = uint64_t{ static_cast<uint32_t>(left[idx]) } - static_cast<uint32_t>(right[idx]) - borrow;
+    borrow = static_cast<uint32_t>(diff >> 63U);
+    left[idx] = static_cast<Limb>(borrow != 0 ? diff + BASE : diff);
+  }
+
+  return borrow;
+}
+
+uint32_t add_in_place(Limb *left, size_t left_size, const Limb *right, size_t right_size) {
+  uint32_t carry = kernels().add(left, right, right_size, 0);
+
+  for (size_t idx = right_size; carry != 0 && idx < left_size; ++idx) {
+    if (static_cast<uint32_t>(left[idx]) == BASE - 1) {
+      left[idx] = 0;
+    } else {
+      ++left[idx];
+      carry = 0;
+    }
+  }
+
+  return carry;
+}
+
+uint32_t sub_in_place(Limb *left, size_t left_size, const Limb *right, size_t right_size) {
+  uint32_t borrow = kernels().sub(left, right, right_size, 0);
+
+  for (size_t idx = right_size; borrow != 0 && idx < left_size; ++idx) {
+    if (left[idx] == 0) {
+      left[idx] = static_cast<Limb>(BASE - 1);
+    } else {
+      --left[idx];
+      borrow = 0;
+    }
+  }
+
+  return borrow;
+}
+
+int8_t compare(const Limb *left, size_t left_size, const Limb *right, size_t right_size) {
+  while (left_size > 0 && left[left_size - 1] == 0) {
+    --left_size;
+  }
+  while (right_size > 0 && right[right_size - 1] == 0) {
+    --right_size;
+  }
+  if (left_size != right_size) {
+    return left_size < right_size ? -1 : 1;
+  }
+  for (size_t idx = left_size; idx > 0; --idx) {
+    if (left[idx - 1] != right[idx - 1]) {
+      return left[idx - 1] < right[idx - 1] ? -1 : 1;
+    }
+  }
+
+  return 0;
+}
+
+size_t word_limbs(int64_t value, std::array<Limb, 3> &result) {
+  size_t size = 0;
+
+  for (uint64_t rest = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value); rest != 0; rest /= BASE) {
+    result[size++] = static_cast<Limb>(rest % BASE);
+  }
+
+  return size;
+}
+
+uint32_t mul_1(Limb *ptr, size_t size, uint32_t factor) {
+  uint64_t carry = 0;
+
+  for (size_t idx = 0; idx < size; ++idx) {
+    carry += static_cast<uint64_t>(static_cast<uint32_t>(ptr[idx])) * factor;
+    ptr[idx] = static_cast<Limb>(carry % BASE);
+    carry /= BASE;
+  }
+
+  return static_cast<uint32_t>(carry);
+}
+
+uint32_t addmul_1(Limb *result, const Limb *ptr, size_t size, uint32_t factor) {
+  uint64_t carry = 0;
+
+  // (BASE - 1)^2 + 2 * (BASE - 1) < BASE^2 <= 2^64, so the carry stays below BASE.
+  for (size_t idx = 0; idx < size; ++idx) {
+    carry += static_cast<uint64_t>(static_cast<uint32_t>(ptr[idx])) * factor + static_cast<uint32_t>(result[idx]);
+    result[idx] = static_cast<Limb>(carry % BASE);
+    carry /= BASE;
+  }
+
+  return static_cast<uint32_t>(carry);
+}
+
+uint32_t submul_1(Limb *result, const Limb *ptr, size_t size, uint32_t factor) {
+  uint64_t carry = 0;
+
+  // The borrow is folded into the product carry: when the high part reaches BASE - 1 the low part is
+  // zero and nothing is borrowed, so the carry stays below BASE.
+  for (size_t idx = 0; idx < size; ++idx) {
+    carry += static_cast<uint64_t>(static_cast<uint32_t>(ptr[idx])) * factor;
+
+    const auto low = static_cast<Limb>(carry % BASE);
+    carry /= BASE;
+
+    if (result[idx] < low) {
+      result[idx] = static_cast<Limb>(result[idx] + BASE - low);
+      ++carry;
+    } else {
+      result[idx] -= low;
+    }
+  }
+
+  return static_cast<uint32_t>(carry);
+}
+
+uint32_t div_1(Limb *ptr, size_t size, uint32_t divisor) {
+  uint64_t remainder = 0;
+
+  for (size_t idx = size; idx > 0; --idx) {
+    remainder = remainder * BASE + static_cast<uint32_t>(ptr[idx - 1]);
+    ptr[idx - 1] = static_cast<Limb>(remainder / divisor);
+    remainder %= divisor;
+  }
+
+  return static_cast<uint32_t>(remainder);
+}
+
+Divisor::Divisor(uint64_t divisor) : normalized(divisor), reciprocal(0), shift(0) {
+  while ((normalized >> 63U) == 0) {
+    normalized <<= 1U;
+    ++shift;
+  }
+  reciprocal = div_wide(~normalized, ~uint64_t{ 0 }, normalized);
+}
+
+uint64_t mod_1(const Limb *ptr, size_t size, const Divisor &divisor) {
+  // The remainder is kept shifted left by divisor.shift, which is the remainder modulo the normalized divisor of
+  // the shifted number.
+  uint64_t remainder = 0;
+
+  for (size_t idx = size; idx > 0; --idx) {
+    const auto limb = static_cast<uint64_t>(static_cast<uint32_t>(ptr[idx - 1]));
+    Wide value = mul_wide(remainder, BASE);
+    const uint64_t shifted_low = limb << divisor.shift;
+    const uint64_t shifted_high = divisor.shift == 0 ? 0 : limb >> (64 - divisor.shift);
+
+    value.low += shifted_low;
+    value.high += shifted_high + (value.low < shifted_low ? 1 : 0);
+    remainder = rem_wide(value.high, value.low, divisor);
+  }
+
+  return remainder >> divisor.shift;
+}
+
+}// namespace BigMath::limbs
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "bigint.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Kernels on little endian spans of limbs in the radix LimbPolicy selects, shared by the Bigint translation units.
+namespace BigMath::limbs {
+
+constexpr uint64_t BASE = LimbPolicy::BASE;
+constexpr bool BINARY = LimbPolicy::BINARY;
+
+// left[0, left_size) += right[0, right_size), left_size >= right_size. Returns the carry out of left.
+uint32_t add_in_place(Limb *left, size_t left_size, const Limb *right, size_t right_size);
+
+// left[0, left_size) -= right[0, right_size), left >= right. Returns the borrow out of left.
+uint32_t sub_in_place(Limb *left, size_t left_size, const Limb *right, size_t right_size);
+
+// left[0, size) += right[0, size) plus an incoming carry of 0 or 1. Returns the carry out of the top limb.
+// add_in_place runs the fastest of these the CPU supports, picked once at first use.
+uint32_t add_n(Limb *left, const Limb *right, size_t size, uint32_t carry);
+
+// left[0, size) -= right[0, size) plus an incoming borrow of 0 or 1. Returns the borrow out of the top limb.
+uint32_t sub_n(Limb *left, const Limb *right, size_t size, uint32_t borrow);
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__)) && !defined(BIGINT_BINARY_LIMBS)
+#define BIGINT_X86_KERNELS
+
+// Vector versions of add_n and sub_n for decimal limbs, only callable when the CPU supports the instruction set. (limbs_x86.cpp)
+uint32_t add_n_avx2(int32_t *left, const int32_t *right, size_t size, uint32_t carry);
+uint32_t sub_n_avx2(int32_t *left, const int32_t *right, size_t size, uint32_t borrow);
+uint32_t add_n_avx512(int32_t *left, const int32_t *right, size_t size, uint32_t carry);
+uint32_t sub_n_avx512(int32_t *left, const int32_t *right, size_t size, uint32_t borrow);
+#endif
+
+// -1, 0 or 1 as left is smaller, equal or larger than right. Leading zero limbs are ignored.
+int8_t compare(const Limb *left, size_t left_size, const Limb *right, size_t right_size);
+
+// result[0, returned size) = limbs of |value|, at most three since |value| <= 2^63.
+size_t word_limbs(int64_t value, std::array<Limb, 3> &result);
+
+// ptr[0, size) *= factor with factor < BASE. Returns the carry out of the top limb.
+uint32_t mul_1(Limb *ptr, size_t size, uint32_t factor);
+
+// result[0, size) += ptr[0, size) * factor with factor < BASE. Returns the carry into result[size], below BASE.
+uint32_t addmul_1(Limb *result, const Limb *ptr, size_t size, uint32_t factor);
+
+// result[0, size) -= ptr[0, size) * factor with factor < BASE. Returns the borrow from result[size], below BASE.
+uint32_t submul_1(Limb *result, const Limb *ptr, size_t size, uint32_t factor);
+
+// ptr[0, size) /= divisor with 0 < divisor < BASE. Returns the remainder.
+uint32_t div_1(Limb *ptr, size_t size, uint32_t divisor);
+
+// A 64-bit divisor shifted so its top bit is set, with the reciprocal floor((2^128 - 1) / normalized) - 2^64.
+// Dividing by it then takes two multiplications instead of a hardware division (Moller and Granlund).
+struct Divisor {
+  explicit Divisor(uint64_t divisor);// divisor non-zero
+
+  uint64_t normalized;
+  uint64_t reciprocal;
+  uint32_t shift;
+};
+
+// ptr[0, size) mod divisor.
+uint64_t mod_1(const Limb *ptr, size_t size, const Divisor &divisor);
+
+// result[0, left_size + right_size) = left * right, left_size and right_size non-zero. (multiplication.cpp)
+void mul(Limb *result, const Limb *left, size_t left_size, const Limb *right, size_t right_size);
+
+// mul on up to threads threads, which only pays off for operands of many thousand limbs. (multiplication.cpp)
+void mul_parallel(Limb *result, const Limb *left, size_t left_size, const Limb *right, size_t right_size, size_t threads);
+
+// result[0, 2 * size) = ptr^2, size non-zero. mul forwards here when both operands are the same span. (multiplication.cpp)
+void sqr(Limb *result, const Limb *ptr, size_t size);
+
+// Operand sizes (in limbs) at which mul and sqr move up to the next algorithm, the defaults in multiplication.cpp.
+// Only the tests change them, to run every tier on operands small enough to check against the schoolbook product.
+struct MulThresholds {
+  size_t karatsuba;
+  size_t toom3;
+  size_t ntt;
+  size_t toom4;
+  size_t sqr_karatsuba;
+};
+extern MulThresholds mul_thresholds;
+
+// quotient[0, left_size - right_size + 1) = left / right and remainder[0, right_size) = left % right,
+// for left_size >= right_size and a non-zero top limb in right. (division.cpp)
+void divmod(Limb *quotient, Limb *remainder, const Limb *left, size_t left_size, const Limb *right, size_t right_size);
+
+}// namespace BigMath::limbs
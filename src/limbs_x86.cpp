@@ -0,0 +1,112 @@
+#include "limbs.h"
+
+#ifdef BIGINT_X86_KERNELS
+
+#include <immintrin.h>
+
+// Lazy carry: every lane is added at once, then the carries are resolved on lane bitmasks. A lane whose sum
+// reached BASE generates a carry, a lane sitting at BASE - 1 passes an incoming carry on. With generate shifted
+// up by one lane as the initial carries, (carries + propagate) ^ propagate marks every lane that receives one,
+// exactly like a ripple through a binary adder, and the bit above the top lane is the carry out of the block.
+// Subtraction is the same with negative differences generating and zero differences propagating a borrow.
+namespace BigMath::limbs {
+
+__attribute__((target("avx2"))) uint32_t add_n_avx2(int32_t *left, const int32_t *right, size_t size, uint32_t carry) {
+  const __m256i top = _mm256_set1_epi32(static_cast<int32_t>(BASE - 1));
+  const __m256i base = _mm256_set1_epi32(static_cast<int32_t>(BASE));
+  const __m256i lanes = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+  size_t idx = 0;
+
+  for (; idx + 8 <= size; idx += 8) {
+    __m256i sum = _mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(left + idx)),
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(right + idx)));
+
+    const auto generate = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(sum, top))));
+    const auto propagate = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(sum, top))));
+    const uint32_t carries = (generate << 1 | carry) + propagate;
+    const __m256i receive = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(static_cast<int32_t>(carries ^ propagate)), lanes), lanes);
+
+    carry = carries >> 8;
+    sum = _mm256_sub_epi32(sum, receive);
+    sum = _mm256_sub_epi32(sum, _mm256_and_si256(_mm256_cmpgt_epi32(sum, top), base));
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(left + idx), sum);
+  }
+
+  return add_n(left + idx, right + idx, size - idx, carry);
+}
+
+__attribute__((target("avx2"))) uint32_t sub_n_avx2(int32_t *left, const int32_t *right, size_t size, uint32_t borrow) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i base = _mm256_set1_epi32(static_cast<int32_t>(BASE));
+  const __m256i lanes = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+  size_t idx = 0;
+
+  for (; idx + 8 <= size; idx += 8) {
+    __m256i diff = _mm256_sub_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(left + idx)),
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(right + idx)));
+
+    const auto generate = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(zero, diff))));
+    const auto propagate = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(diff, zero))));
+    const uint32_t borrows = (generate << 1 | borrow) + propagate;
+    const __m256i receive = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(static_cast<int32_t>(borrows ^ propagate)), lanes), lanes);
+
+    borrow = borrows >> 8;
+    diff = _mm256_add_epi32(diff, receive);
+    diff = _mm256_add_epi32(diff, _mm256_and_si256(_mm256_cmpgt_epi32(zero, diff), base));
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(left + idx), diff);
+  }
+
+  return sub_n(left + idx, right + idx, size - idx, borrow);
+}
+
+__attribute__((target("avx512f"))) uint32_t add_n_avx512(int32_t *left, const int32_t *right, size_t size, uint32_t carry) {
+  const __m512i top = _mm512_set1_epi32(static_cast<int32_t>(BASE - 1));
+  const __m512i base = _mm512_set1_epi32(static_cast<int32_t>(BASE));
+  const __m512i one = _mm512_set1_epi32(1);
+  size_t idx = 0;
+
+  for (; idx + 16 <= size; idx += 16) {
+    __m512i sum = _mm512_add_epi32(_mm512_loadu_si512(left + idx), _mm512_loadu_si512(right + idx));
+
+    const uint32_t generate = _mm512_cmpgt_epi32_mask(sum, top);
+    const uint32_t propagate = _mm512_cmpeq_epi32_mask(sum, top);
+    const uint32_t carries = (generate << 1 | carry) + propagate;
+
+    carry = carries >> 16;
+    sum = _mm512_mask_add_epi32(sum, static_cast<__mmask16>(carries ^ propagate), sum, one);
+    sum = _mm512_mask_sub_epi32(sum, _mm512_cmpgt_epi32_mask(sum, top), sum, base);
+
+    _mm512_storeu_si512(left + idx, sum);
+  }
+
+  return add_n(left + idx, right + idx, size - idx, carry);
+}
+
+__attribute__((target("avx512f"))) uint32_t sub_n_avx512(int32_t *left, const int32_t *right, size_t size, uint32_t borrow) {
+  const __m512i zero = _mm512_setzero_si512();
+  const __m512i base = _mm512_set1_epi32(static_cast<int32_t>(BASE));
+  const __m512i one = _mm512_set1_epi32(1);
+  size_t idx = 0;
+
+  for (; idx + 16 <= size; idx += 16) {
+    __m512i diff = _mm512_sub_epi32(_mm512_loadu_si512(left + idx), _mm512_loadu_si512(right + idx));
+
+    const uint32_t generate = _mm512_cmplt_epi32_mask(diff, zero);
+    const uint32_t propagate = _mm512_cmpeq_epi32_mask(diff, zero);
+    const uint32_t borrows = (generate << 1 | borrow) + propagate;
+
+    borrow = borrows >> 16;
+    diff = _mm512_mask_sub_epi32(diff, static_cast<__mmask16>(borrows ^ propagate), diff, one);
+    diff = _mm512_mask_add_epi32(diff, _mm512_cmplt_epi32_mask(diff, zero), diff, base);
+
+    _mm512_storeu_si512(left + idx, diff);
+  }
+
+  return sub_n(left + idx, right + idx, size - idx, borrow);
+}
+
+}// namespace BigMath::limbs
+
+#endif// BIGINT_X86_KERNELS
@@ -0,0 +1,274 @@
+#include "modcontext.h"
+#include "limbs.h"
+
+#include <stdexcept>
+#include <vector>
+
+namespace BigMath {
+
+namespace limbs {
+
+namespace {
+
+// Modulus size (in limbs) from which Barrett, whose products go through Karatsuba, beats the row by row Montgomery
+// reduction even for moduli coprime to BASE.
+constexpr size_t MONTGOMERY_THRESHOLD = 32;
+
+// ptr[0, size) += value with value < BASE, the sum must fit in the span.
+void add_1(Limb *ptr, size_t size, uint32_t value) {
+  for (size_t i = 0; value != 0 && i < size; ++i) {
+    const uint64_t sum = uint64_t{ static_cast<uint32_t>(ptr[i]) } + value;
+    value = sum >= BASE ? 1 : 0;
+    ptr[i] = static_cast<Limb>(sum - value * BASE);
+  }
+}
+
+// -m^-1 mod BASE for m coprime to BASE. Each Newton step x = x * (2 - m * x) doubles the number of correct digits,
+// from the one decimal digit of the table or the three bits of an odd m, which is its own inverse modulo 8.
+uint32_t negated_inverse(uint32_t m) {
+  constexpr std::array<uint64_t, 10> INVERSE_MOD_10 = { 0, 1, 0, 7, 0, 0, 0, 3, 0, 9 };
+
+  uint64_t x = BINARY ? m : INVERSE_MOD_10[m % 10];
+  for (int32_t step = 0; step < 4; ++step) {
+    x = x * ((2 + BASE - m * x % BASE) % BASE) % BASE;
+  }
+
+  return static_cast<uint32_t>(BASE - x);
+}
+
+// Montgomery reduction, product[0, 2 * size + 1) below m * R becomes product / R mod m in product[size, 2 * size].
+void redc(Limb *product, const Limb *mod, size_t size, uint32_t inverse) {
+  for (size_t i = 0; i < size; ++i) {
+    const auto factor = static_cast<uint32_t>(static_cast<uint64_t>(product[i]) * inverse % BASE);
+    add_1(product + i + size, size + 1 - i, addmul_1(product + i, mod, size, factor));
+  }
+
+  Limb *residue = product + size;
+  if (compare(residue, size + 1, mod, size) >= 0) {
+    sub_in_place(residue, size + 1, mod, size);
+  }
+}
+
+// Barrett reduction, product[0, 2 * size) mod m in product[0, size]. scratch holds 2 * (size + mu_size) + 1 limbs.
+void barrett(Limb *product, const Limb *mod, size_t size, const Limb *mu, size_t mu_size, Limb *scratch) {
+  // quotient = floor(floor(product / BASE^(size - 1)) * mu / BASE^(size + 1)), at most 2 below the real quotient
+  Limb *estimate = scratch;
+  mul(estimate, product + size - 1, size + 1, mu, mu_size);
+
+  const Limb *quotient = estimate + size + 1;
+  size_t quotient_size = mu_size;
+  while (quotient_size > 0 && quotient[quotient_size - 1] == 0) {
+    --quotient_size;
+  }
+
+  if (quotient_size > 0) {
+    Limb *multiple = estimate + size + 1 + mu_size;
+    mul(multiple, quotient, quotient_size, mod, size);
+    sub_n(product, multiple, size + 1, 0);// the difference is below 3m, so its low size + 1 limbs are exact
+  }
+
+  while (compare(product, size + 1, mod, size) >= 0) {
+    sub_in_place(product, size + 1, mod, size);
+  }
+}
+
+}// namespace
+
+}// namespace limbs
+
+ModContext::ModContext(const Bigint &modulus)
+    : mod(modulus), r_squared(modulus.get_allocator()), mu(modulus.get_allocator()), one(modulus.get_allocator()) {
+  if (!mod.positive || mod == Bigint()) {
+    throw std::invalid_argument("Modulus must be positive");
+  }
+
+  while (mod.number.back() == 0) {
+    mod.number.pop_back();
+  }
+  size = mod.number.size();
+
+  // R^2 = BASE^(2 * size)
+  Bigint power(mod.get_allocator());
+  power.number.resize(2 * size + 1);
+  power.number[2 * size] = 1;
+
+  auto [quotient, remainder] = divmod(power, mod);
+  const auto low = static_cast<uint32_t>(mod.number[0]);
+  if (low % 2 != 0 && (limbs::BINARY || low % 5 != 0) && size < limbs::MONTGOMERY_THRESHOLD) {
+    inverse = limbs::negated_inverse(low);
+    r_squared = std::move(remainder);
+  } else {
+    mu = std::move(quotient);
+  }
+
+  one = to_residue(Bigint(1, mod.get_allocator()));
+}
+
+const Bigint &ModContext::modulus() const {
+  return mod;
+}
+
+bool ModContext::is_montgomery() const {
+  return inverse != 0;
+}
+
+Bigint ModContext::to_residue(const Bigint &value) const {
+  Bigint reduced = value.positive && value.compare(mod) < 0 ? value : value % mod;
+  if (!reduced.positive) {
+    reduced += mod;
+  }
+
+  return is_montgomery() ? mulmod(reduced, r_squared) : reduced;
+}
+
+Bigint ModContext::from_residue(const Bigint &residue) const {
+  const size_t residue_limbs = residue_size(residue);
+  if (!is_montgomery() || residue_limbs == 0) {
+    return Bigint(residue);
+  }
+
+  SmallVector<Limb> product(residue.get_allocator().resource());
+  product.resize(2 * size + 1);
+  std::copy(residue.number.begin(), residue.number.begin() + residue_limbs, product.begin());
+
+  return reduce(product, residue.get_allocator());
+}
+
+Bigint ModContext::mulmod(const Bigint &left, const Bigint &right) const {
+  const size_t left_size = residue_size(left);
+  const size_t right_size = residue_size(right);
+  if (left_size == 0 || right_size == 0) {
+    return Bigint(left.get_allocator());
+  }
+
+  SmallVector<Limb> product(left.get_allocator().resource());
+  product.resize(2 * size + 1);
+  limbs::mul(product.begin(), left.number.begin(), left_size, right.number.begin(), right_size);
+
+  return reduce(product, left.get_allocator());
+}
+
+Bigint ModContext::sqrmod(const Bigint &residue) const {
+  const size_t residue_limbs = residue_size(residue);
+  if (residue_limbs == 0) {
+    return Bigint(residue.get_allocator());
+  }
+
+  SmallVector<Limb> product(residue.get_allocator().resource());
+  product.resize(2 * size + 1);
+  limbs::sqr(product.begin(), residue.number.begin(), residue_limbs);
+
+  return reduce(product, residue.get_allocator());
+}
+
+Bigint ModContext::powmod(const Bigint &residue, const Bigint &exponent) const {
+  if (!exponent.positive) {
+    throw std::invalid_argument("Exponent must be non negative");
+  }
+  static_cast<void>(residue_size(residue));// only validates
+
+  // Binary digits of the exponent, 29 at a time since 2^29 < BASE
+  constexpr uint32_t CHUNK_BITS = 29;
+  std::vector<uint32_t> chunks;
+  std::vector<Limb> digits(exponent.number.begin(), exponent.number.end());
+  while (!digits.empty() && digits.back() == 0) {
+    digits.pop_back();
+  }
+  while (!digits.empty()) {
+    chunks.push_back(limbs::div_1(digits.data(), digits.size(), uint32_t{ 1 } << CHUNK_BITS));
+    while (!digits.empty() && digits.back() == 0) {
+      digits.pop_back();
+    }
+  }
+
+  if (chunks.empty()) {
+    return Bigint(one, residue.get_allocator());
+  }
+
+  size_t bits = CHUNK_BITS * (chunks.size() - 1);
+  for (uint32_t top = chunks.back(); top != 0; top >>= 1U) {
+    ++bits;
+  }
+  const auto bit_at = [&chunks](size_t index) { return (chunks[index / CHUNK_BITS] >> (index % CHUNK_BITS)) & 1U; };
+
+  // Left-to-right sliding window over odd_powers[i] = residue^(2i + 1)
+  const size_t width = bits > 671 ? 6 : bits > 239 ? 5 : bits > 79 ? 4 : bits > 23 ? 3 : bits > 6 ? 2 : 1;
+  const size_t table_size = size_t{ 1 } << (width - 1);
+  std::vector<Bigint> odd_powers;
+  odd_powers.reserve(table_size);
+  odd_powers.push_back(residue);
+  if (width > 1) {
+    const Bigint residue_squared = sqrmod(residue);
+    while (odd_powers.size() < table_size) {
+      odd_powers.push_back(mulmod(odd_powers.back(), residue_squared));
+    }
+  }
+
+  Bigint result(residue.get_allocator());
+  bool started = false;
+  for (size_t bit = bits; bit > 0;) {
+    if (bit_at(bit - 1) == 0) {
+      result = sqrmod(result);
+      --bit;
+      continue;
+    }
+
+    size_t low = bit > width ? bit - width : 0;
+    while (bit_at(low) == 0) {
+      ++low;
+    }
+    size_t window = 0;
+    for (size_t i = bit; i > low; --i) {
+      window = 2 * window + bit_at(i - 1);
+    }
+
+    if (!started) {
+      result = odd_powers[window / 2];
+      started = true;
+    } else {
+      for (size_t i = low; i < bit; ++i) {
+        result = sqrmod(result);
+      }
+      result = mulmod(result, odd_powers[window / 2]);
+    }
+    bit = low;
+  }
+
+  return result;
+}
+
+size_t ModContext::residue_size(const Bigint &residue) const {
+  size_t residue_limbs = residue.number.size();
+  while (residue_limbs > 0 && residue.number[residue_limbs - 1] == 0) {
+    --residue_limbs;
+  }
+
+  if (!residue.positive || limbs::compare(residue.number.begin(), residue_limbs, mod.number.begin(), size) >= 0) {
+    throw std::invalid_argument("Not a residue of the modulus");
+  }
+
+  return residue_limbs;
+}
+
+Bigint ModContext::reduce(SmallVector<Limb> &product, const Bigint::allocator_type &allocator) const {
+  const Limb *residue = product.begin();
+  if (is_montgomery()) {
+    limbs::redc(product.begin(), mod.number.begin(), size, inverse);
+    residue += size;
+  } else {
+    SmallVector<Limb> scratch(allocator.resource());
+    scratch.resize(2 * (size + mu.number.size()) + 1);
+    limbs::barrett(product.begin(), mod.number.begin(), size, mu.number.begin(), mu.number.size(), scratch.begin());
+  }
+
+  Bigint result(allocator);
+  result.number.resize(size);
+  std::copy(residue, residue + size, result.number.begin());
+  while (!result.number.empty() && result.number.back() == 0) {
+    result.number.pop_back();
+  }
+
+  return result;
+}
+
+}// namespace BigMath
@@ -0,0 +1,1084 @@
+#include "bigint.h"
+#include "limbs.h"
+#include "parallel.h"
+
+#include <thread>
+#include <vector>
+
+namespace BigMath {
+
+namespace limbs {
+
+namespace {
+
+// Shorter operand size (in limbs) from which Karatsuba beats the schoolbook loop.
+constexpr size_t KARATSUBA_THRESHOLD = 48;
+// Shorter operand size (in limbs) from which Toom-3 beats Karatsuba.
+constexpr size_t TOOM3_THRESHOLD = 160;
+// Shorter operand size (in limbs) from which the number-theoretic transform beats Toom-Cook. mul and sqr check it
+// before the Toom-Cook tiers, so Toom-3 covers the sizes from TOOM3_THRESHOLD up to here.
+constexpr size_t NTT_THRESHOLD = 800;
+// Shorter operand size (in limbs) from which Toom-4 beats Toom-3, measured before the NTT existed. Being above
+// NTT_THRESHOLD, it only matters for products longer than NTT_MAX_SIZE, which Toom-4 splits into seven the NTT takes.
+constexpr size_t TOOM4_THRESHOLD = 4000;
+// Operand size (in limbs) from which Karatsuba squaring beats the schoolbook square, which does half the work.
+constexpr size_t SQR_KARATSUBA_THRESHOLD = 64;
+// Shorter operand size (in limbs) from which mul_parallel spreads a product over threads. Starting a team of 8
+// and passing the ~40 barriers of a product costs under 1 ms, below 4% of a 20000-limb product run serially.
+constexpr size_t PARALLEL_THRESHOLD = 20000;
+
+// result[0, left_size) = left + right, left_size >= right_size. Returns the carry.
+uint32_t add_limbs(Limb *result, const Limb *left, size_t left_size, const Limb *right, size_t right_size) {
+  std::copy(left, left + left_size, result);
+
+  return add_in_place(result, left_size, right, right_size);
+}
+
+// Rows of products a uint64_t column can take before it has to be normalized:
+// a carried-in column (< 2^35) plus 18 * (BASE - 1)^2 stays below 2^64.
+constexpr size_t ROWS_PER_CARRY = 18;
+
+// result[0, left_size + right_size) = left * right
+// Products are accumulated into 64-bit columns and carried once every ROWS_PER_CARRY rows. A single product of two
+// binary limbs fills a column, so those are added in one row at a time by addmul_1.
+void mul_basecase(Limb *result, const Limb *left, size_t left_size, const Limb *right, size_t right_size) {
+  const size_t size = left_size + right_size;
+
+  if constexpr (BINARY) {
+    std::fill(result, result + size, 0);
+    for (size_t i = 0; i < right_size; ++i) {
+      result[i + left_size] = static_cast<Limb>(addmul_1(result + i, left, left_size, static_cast<uint32_t>(right[i])));
+    }
+    return;
+  }
+
+  SmallVector<uint64_t> columns(size + 1);
+
+  for (size_t row = 0; row < left_size; row += ROWS_PER_CARRY) {
+    const size_t last_row = std::min(left_size, row + ROWS_PER_CARRY);
+
+    for (size_t i = row; i < last_row; ++i) {
+      const uint64_t multiplier = static_cast<uint32_t>(left[i]);
+      uint64_t *column = columns.begin() + i;
+
+      for (size_t j = 0; j < right_size; ++j) {
+        column[j] += multiplier * static_cast<uint32_t>(right[j]);
+      }
+    }
+
+    uint64_t carry = 0;
+
+    for (size_t idx = row; idx < last_row + right_size; ++idx) {
+      carry += columns[idx];
+      columns[idx] = carry % BASE;
+      carry /= BASE;
+    }
+    columns[last_row + right_size] += carry;
+  }
+
+  for (size_t idx = 0; idx < size; ++idx) {
+    result[idx] = static_cast<Limb>(columns[idx]);
+  }
+}
+
+// Karatsuba for left_size / 2 < right_size <= left_size:
+// (l1 * B + l0)(r1 * B + r0) = l1r1 * B^2 + ((l0 + l1)(r0 + r1) - l0r0 - l1r1) * B + l0r0
+void karatsuba(Limb *result, const Limb *left, size_t left_size, const Limb *right, size_t right_size) {
+  const size_t half = (left_size + 1) / 2;
+  const size_t left_high = left_size - half;
+  const size_t right_high = right_size - half;
+
+  mul(result, left, half, right, half);
+  mul(result + 2 * half, left + half, left_high, right + half, right_high);
+
+  SmallVector<Limb> scratch(4 * half + 4);
+  Limb *left_sum = scratch.begin();
+  Limb *right_sum = left_sum + half + 1;
+  Limb *middle = right_sum + half + 1;
+
+  left_sum[half] = static_cast<Limb>(add_limbs(left_sum, left, half, left + half, left_high));
+  right_sum[half] = static_cast<Limb>(add_limbs(right_sum, right, half, right + half, right_high));
+
+  size_t middle_size = 2 * half + 2;
+
+  mul(middle, left_sum, half + 1, right_sum, half + 1);
+  sub_in_place(middle, middle_size, result, 2 * half);
+  sub_in_place(middle, middle_size, result + 2 * half, left_high + right_high);
+
+  while (middle_size > 0 && middle[middle_size - 1] == 0) {
+    --middle_size;
+  }
+
+  add_in_place(result + half, left_size + right_size - half, middle, middle_size);
+}
+
+// result[0, 2 * size) = ptr^2
+// Each cross product ptr[i] * ptr[j], i < j, is accumulated once into the columns like mul_basecase does,
+// then the cross sum is doubled and the squares ptr[i]^2 are added on the diagonal.
+void sqr_basecase(Limb *result, const Limb *ptr, size_t size) {
+  if constexpr (BINARY) {
+    std::fill(result, result + 2 * size, 0);
+    for (size_t i = 0; i + 1 < size; ++i) {
+      result[i + size] = static_cast<Limb>(addmul_1(result + 2 * i + 1, ptr + i + 1, size - i - 1, static_cast<uint32_t>(ptr[i])));
+    }
+    mul_1(result, 2 * size, 2);
+
+    uint64_t carry = 0;
+    for (size_t i = 0; i < size; ++i) {
+      const uint64_t square = uint64_t{ static_cast<uint32_t>(ptr[i]) } * static_cast<uint32_t>(ptr[i]);
+
+      carry += result[2 * i] + square % BASE;
+      result[2 * i] = static_cast<Limb>(carry % BASE);
+      carry = carry / BASE + result[2 * i + 1] + square / BASE;
+      result[2 * i + 1] = static_cast<Limb>(carry % BASE);
+      carry /= BASE;
+    }
+    return;
+  }
+
+  SmallVector<uint64_t> columns(2 * size + 1);
+
+  for (size_t row = 0; row < size; row += ROWS_PER_CARRY) {
+    const size_t last_row = std::min(size, row + ROWS_PER_CARRY);
+
+    for (size_t i = row; i < last_row; ++i) {
+      const uint64_t multiplier = static_cast<uint32_t>(ptr[i]);
+      uint64_t *column = columns.begin() + i;
+
+      for (size_t j = i + 1; j < size; ++j) {
+        column[j] += multiplier * static_cast<uint32_t>(ptr[j]);
+      }
+    }
+
+    uint64_t carry = 0;
+
+    for (size_t idx = 2 * row + 1; idx < last_row + size - 1; ++idx) {
+      carry += columns[idx];
+      columns[idx] = carry % BASE;
+      carry /= BASE;
+    }
+    columns[last_row + size - 1] += carry;
+  }
+
+  uint64_t carry = 0;
+
+  for (size_t idx = 0; idx < 2 * size; ++idx) {
+    carry += 2 * columns[idx];
+    if (idx % 2 == 0) {
+      const uint64_t digit = static_cast<uint32_t>(ptr[idx / 2]);
+      carry += digit * digit;
+    }
+    result[idx] = static_cast<Limb>(carry % BASE);
+    carry /= BASE;
+  }
+}
+
+// Karatsuba squaring: (a1 * B + a0)^2 = a1^2 * B^2 + ((a0 + a1)^2 - a0^2 - a1^2) * B + a0^2
+void sqr_karatsuba(Limb *result, const Limb *ptr, size_t size) {
+  const size_t half = (size + 1) / 2;
+  const size_t high = size - half;
+
+  sqr(result, ptr, half);
+  sqr(result + 2 * half, ptr + half, high);
+
+  SmallVector<Limb> scratch(3 * half + 3);
+  Limb *sum = scratch.begin();
+  Limb *middle = sum + half + 1;
+
+  sum[half] = static_cast<Limb>(add_limbs(sum, ptr, half, ptr + half, high));
+
+  size_t middle_size = 2 * half + 2;
+
+  sqr(middle, sum, half + 1);
+  sub_in_place(middle, middle_size, result, 2 * half);
+  sub_in_place(middle, middle_size, result + 2 * half, 2 * high);
+
+  while (middle_size > 0 && middle[middle_size - 1] == 0) {
+    --middle_size;
+  }
+
+  add_in_place(result + half, 2 * size - half, middle, middle_size);
+}
+
+// Splits the longer operand into right_size-limb blocks so each partial product is balanced.
+void mul_unbalanced(Limb *result, const Limb *left, size_t left_size, const Limb *right, size_t right_size, size_t threads) {
+  std::fill(result, result + left_size + right_size, 0);
+
+  SmallVector<Limb> partial(2 * right_size);
+
+  for (size_t offset = 0; offset < left_size; offset += right_size) {
+    const size_t block = std::min(right_size, left_size - offset);
+
+    mul_parallel(partial.begin(), left + offset, block, right, right_size, threads);
+    add_in_place(result + offset, left_size + right_size - offset, partial.begin(), block + right_size);
+  }
+}
+
+
+// Signed value used by the Toom-Cook evaluation and interpolation steps.
+struct Term {
+  SmallVector<Limb> limbs;// little endian, without leading zeroes
+  bool negative = false;
+};
+
+void trim(Term &term) {
+  while (!term.limbs.empty() && term.limbs.back() == 0) {
+    term.limbs.pop_back();
+  }
+  if (term.limbs.empty()) {
+    term.negative = false;
+  }
+}
+
+// Limbs [which * size, (which + 1) * size) of ptr, clamped to count.
+Term piece(const Limb *ptr, size_t count, size_t which, size_t size) {
+  const size_t begin = std::min(count, which * size);
+  Term term{ SmallVector<Limb>(ptr + begin, std::min(count, begin + size) - begin) };
+
+  trim(term);
+
+  return term;
+}
+
+void add_signed(Term &left, const Term &right, bool right_negative) {
+  const size_t left_size = left.limbs.size();
+  const size_t right_size = right.limbs.size();
+
+  if (left.negative == right_negative || left_size == 0) {
+    left.limbs.resize(std::max(left_size, right_size) + 1);
+    add_in_place(left.limbs.begin(), left.limbs.size(), right.limbs.begin(), right_size);
+    left.negative = right_negative;
+  } else if (compare(left.limbs.begin(), left_size, right.limbs.begin(), right_size) >= 0) {
+    sub_in_place(left.limbs.begin(), left_size, right.limbs.begin(), right_size);
+  } else {
+    SmallVector<Limb> difference = right.limbs;
+
+    sub_in_place(difference.begin(), right_size, left.limbs.begin(), left_size);
+    left.limbs = std::move(difference);
+    left.negative = right_negative;
+  }
+
+  trim(left);
+}
+
+Term &operator+=(Term &left, const Term &right) {
+  add_signed(left, right, right.negative);
+
+  return left;
+}
+
+Term &operator-=(Term &left, const Term &right) {
+  add_signed(left, right, !right.negative);
+
+  return left;
+}
+
+Term operator+(Term left, const Term &right) {
+  return left += right;
+}
+
+Term operator-(Term left, const Term &right) {
+  return left -= right;
+}
+
+Term &operator*=(Term &term, int32_t value) {
+  if (value == 1) {
+    return term;
+  }
+  if (value < 0) {
+    term.negative = !term.negative;
+    value = -value;
+  }
+
+  const uint32_t carry = mul_1(term.limbs.begin(), term.limbs.size(), static_cast<uint32_t>(value));
+
+  if (carry != 0) {
+    term.limbs.push_back(static_cast<Limb>(carry));
+  }
+  trim(term);
+
+  return term;
+}
+
+// Division by a small value known to leave no remainder.
+Term &operator/=(Term &term, uint32_t value) {
+  div_1(term.limbs.begin(), term.limbs.size(), value);
+  trim(term);
+
+  return term;
+}
+
+Term operator*(const Term &left, const Term &right) {
+  Term product;
+
+  if (left.limbs.empty() || right.limbs.empty()) {
+    return product;
+  }
+
+  product.limbs.resize(left.limbs.size() + right.limbs.size());
+  mul(product.limbs.begin(), left.limbs.begin(), left.limbs.size(), right.limbs.begin(), right.limbs.size());
+  product.negative = left.negative != right.negative;
+  trim(product);
+
+  return product;
+}
+
+Term multiply(const Term &left, const Term &right, size_t threads) {
+  Term product;
+
+  if (left.limbs.empty() || right.limbs.empty()) {
+    return product;
+  }
+
+  product.limbs.resize(left.limbs.size() + right.limbs.size());
+  mul_parallel(product.limbs.begin(), left.limbs.begin(), left.limbs.size(), right.limbs.begin(), right.limbs.size(), threads);
+  product.negative = left.negative != right.negative;
+  trim(product);
+
+  return product;
+}
+
+Term square(const Term &term) {
+  Term product;
+
+  if (term.limbs.empty()) {
+    return product;
+  }
+
+  product.limbs.resize(2 * term.limbs.size());
+  sqr(product.limbs.begin(), term.limbs.begin(), term.limbs.size());
+  trim(product);
+
+  return product;
+}
+
+// Values of the polynomial with the given coefficients at a small point and at its negation.
+// The even and odd halves are evaluated separately with Horner's scheme and shared by both points.
+template<size_t N>
+std::pair<Term, Term> evaluate(const std::array<Term, N> &coefficients, int32_t point) {
+  const int32_t square = point * point;
+  Term even;
+  Term odd;
+
+  for (size_t idx = N; idx > 0; --idx) {
+    Term &half = (idx - 1) % 2 == 0 ? even : odd;
+
+    half *= square;
+    half += coefficients[idx - 1];
+  }
+  odd *= point;
+
+  return { even + odd, even - odd };
+}
+
+// result = sum of coefficients[i] * BASE^(i * size). The coefficients of a product are non-negative.
+template<size_t N>
+void recompose(Limb *result, size_t result_size, const std::array<Term, N> &coefficients, size_t size) {
+  std::fill(result, result + result_size, 0);
+
+  for (size_t idx = 0; idx < N; ++idx) {
+    const SmallVector<Limb> &limbs = coefficients[idx].limbs;
+
+    add_in_place(result + idx * size, result_size - idx * size, limbs.begin(), limbs.size());
+  }
+}
+
+template<size_t N>
+std::array<Term, N> split(const Limb *ptr, size_t count, size_t size) {
+  std::array<Term, N> pieces;
+
+  for (size_t idx = 0; idx < N; ++idx) {
+    pieces[idx] = piece(ptr, count, idx, size);
+  }
+
+  return pieces;
+}
+
+// Coefficients of the degree 4 product from its values at 0, 1, -1, -2 and infinity, with Bodrato's
+// interpolation sequence.
+std::array<Term, 5> interpolate3(const Term &w0, const Term &w1, const Term &w_minus1, const Term &w_minus2, const Term &w_inf) {
+  std::array<Term, 5> r;
+  r[0] = w0;
+  r[4] = w_inf;
+  r[3] = w_minus2 - w1;
+  r[3] /= 3;
+  r[1] = w1 - w_minus1;
+  r[1] /= 2;
+  r[2] = w_minus1 - w0;
+  r[3] = r[2] - r[3];
+  r[3] /= 2;
+  r[3] += w_inf + w_inf;
+  r[2] += r[1];
+  r[2] -= r[4];
+  r[1] -= r[3];
+
+  return r;
+}
+
+// Toom-3 for 2 * left_size / 3 < right_size <= left_size, evaluated at 0, 1, -1, -2 and infinity.
+void toom33(Limb *result, const Limb *left, size_t left_size, const Limb *right, size_t right_size) {
+  const size_t size = (left_size + 2) / 3;
+  const auto a = split<3>(left, left_size, size);
+  const auto b = split<3>(right, right_size, size);
+
+  const auto [a1, a_minus1] = evaluate(a, 1);
+  const auto [b1, b_minus1] = evaluate(b, 1);
+  const auto [a2, a_minus2] = evaluate(a, 2);
+  const auto [b2, b_minus2] = evaluate(b, 2);
+
+  const auto r = interpolate3(a[0] * b[0], a1 * b1, a_minus1 * b_minus1, a_minus2 * b_minus2, a[2] * b[2]);
+
+  recompose(result, left_size + right_size, r, size);
+}
+
+// Toom-3 squaring, the five pointwise products become squares.
+void sqr_toom3(Limb *result, const Limb *ptr, size_t count) {
+  const size_t size = (count + 2) / 3;
+  const auto a = split<3>(ptr, count, size);
+
+  const auto [a1, a_minus1] = evaluate(a, 1);
+  const auto [a2, a_minus2] = evaluate(a, 2);
+
+  const auto r = interpolate3(square(a[0]), square(a1), square(a_minus1), square(a_minus2), square(a[2]));
+
+  recompose(result, 2 * count, r, size);
+}
+
+// Toom-3/2 for left_size / 2 < right_size <= 2 * ceil(left_size / 3): left in three pieces, right in two,
+// evaluated at 0, 1, -1 and infinity.
+void toom32(Limb *result, const Limb *left, size_t left_size, const Limb *right, size_t right_size) {
+  const size_t size = (left_size + 2) / 3;
+  const auto a = split<3>(left, left_size, size);
+  const auto b = split<2>(right, right_size, size);
+
+  const auto [a1, a_minus1] = evaluate(a, 1);
+  const auto [b1, b_minus1] = evaluate(b, 1);
+
+  const Term w1 = a1 * b1;
+  const Term w_minus1 = a_minus1 * b_minus1;
+
+  std::array<Term, 4> r;
+  r[0] = a[0] * b[0];
+  r[3] = a[2] * b[1];
+  r[1] = w1 - w_minus1;
+  r[1] /= 2;
+  r[1] -= r[3];
+  r[2] = w1 + w_minus1;
+  r[2] /= 2;
+  r[2] -= r[0];
+
+  recompose(result, left_size + right_size, r, size);
+}
+
+// Coefficients of the degree 6 product from its values at 0, 1, -1, 2, -2, 3 and infinity.
+std::array<Term, 7> interpolate4(const Term &w0, const Term &w1, const Term &w_minus1, const Term &w2, const Term &w_minus2, const Term &w3, const Term &w_inf) {
+  std::array<Term, 7> r;
+  r[0] = w0;
+  r[6] = w_inf;
+
+  // Even coefficients: r2 + r4 and 4 * r2 + 16 * r4.
+  Term even1 = w1 + w_minus1;
+  even1 /= 2;
+  even1 -= r[0] + r[6];
+  Term even2 = w2 + w_minus2;
+  even2 /= 2;
+  Term r6_times64 = r[6];
+  r6_times64 *= 64;
+  even2 -= r[0] + r6_times64;
+  Term even1_times4 = even1;
+  even1_times4 *= 4;
+  r[4] = even2 - even1_times4;
+  r[4] /= 12;
+  r[2] = even1 - r[4];
+
+  // Odd coefficients: r1 + r3 + r5, r1 + 4 * r3 + 16 * r5 and r1 + 9 * r3 + 81 * r5.
+  Term odd1 = w1 - w_minus1;
+  odd1 /= 2;
+  Term odd2 = w2 - w_minus2;
+  odd2 /= 4;
+  Term odd3 = w3 - r[0];
+  Term known = r[2];
+  known *= 9;
+  odd3 -= known;
+  known = r[4];
+  known *= 81;
+  odd3 -= known;
+  known = r[6];
+  known *= 729;
+  odd3 -= known;
+  odd3 /= 3;
+
+  Term d1 = odd2 - odd1;// 3 * r3 + 15 * r5
+  d1 /= 3;
+  Term d2 = odd3 - odd2;// 5 * r3 + 65 * r5
+  d2 /= 5;
+  r[5] = d2 - d1;
+  r[5] /= 8;
+  Term r5_times5 = r[5];
+  r5_times5 *= 5;
+  r[3] = d1 - r5_times5;
+  r[1] = odd1 - r[3];
+  r[1] -= r[5];
+
+  return r;
+}
+
+// Toom-4 for 2 * left_size / 3 < right_size <= left_size, evaluated at 0, 1, -1, 2, -2, 3 and infinity.
+// With threads > 1 the seven pointwise products run side by side, sharing the threads between them.
+void toom44(Limb *result, const Limb *left, size_t left_size, const Limb *right, size_t right_size, size_t threads) {
+  const size_t size = (left_size + 3) / 4;
+  const auto a = split<4>(left, left_size, size);
+  const auto b = split<4>(right, right_size, size);
+
+  auto [a1, a_minus1] = evaluate(a, 1);
+  auto [b1, b_minus1] = evaluate(b, 1);
+  auto [a2, a_minus2] = evaluate(a, 2);
+  auto [b2, b_minus2] = evaluate(b, 2);
+
+  const std::array<Term, 7> a_values = { a[0], std::move(a1), std::move(a_minus1), std::move(a2), std::move(a_minus2),
+    evaluate(a, 3).first, a[3] };
+  const std::array<Term, 7> b_values = { b[0], std::move(b1), std::move(b_minus1), std::move(b2), std::move(b_minus2),
+    evaluate(b, 3).first, b[3] };
+  std::array<Term, 7> w;
+  parallel_for(w.size(), threads, [&](size_t first, size_t last) {
+    for (size_t idx = first; idx < last; ++idx) {
+      w[idx] = multiply(a_values[idx], b_values[idx], std::max<size_t>(threads / w.size(), 1));
+    }
+  });
+
+  const auto r = interpolate4(w[0], w[1], w[2], w[3], w[4], w[5], w[6]);
+
+  recompose(result, left_size + right_size, r, size);
+}
+
+// Toom-4 squaring, the seven pointwise products become squares.
+void sqr_toom4(Limb *result, const Limb *ptr, size_t count) {
+  const size_t size = (count + 3) / 4;
+  const auto a = split<4>(ptr, count, size);
+
+  const auto [a1, a_minus1] = evaluate(a, 1);
+  const auto [a2, a_minus2] = evaluate(a, 2);
+
+  const auto r = interpolate4(square(a[0]), square(a1), square(a_minus1), square(a2), square(a_minus2),
+    square(evaluate(a, 3).first), square(a[3]));
+
+  recompose(result, 2 * count, r, size);
+}
+
+constexpr uint32_t power_mod(uint32_t base, uint64_t exponent, uint32_t mod) {
+  uint64_t result = 1;
+  uint64_t square = base;
+
+  for (; exponent != 0; exponent >>= 1U) {
+    if ((exponent & 1U) != 0) {
+      result = result * square % mod;
+    }
+    square = square * square % mod;
+  }
+
+  return static_cast<uint32_t>(result);
+}
+
+// Number-theoretic transform modulo the prime MOD = k * 2^LOG_ORDER + 1 with primitive root ROOT.
+template<uint32_t MOD, uint32_t ROOT, uint32_t LOG_ORDER>
+struct Ntt {
+  static constexpr uint32_t mod = MOD;
+  static constexpr size_t max_size = size_t{ 1 } << LOG_ORDER;
+
+  static uint32_t mul(uint32_t left, uint32_t right) {
+    return static_cast<uint32_t>(static_cast<uint64_t>(left) * right % MOD);
+  }
+
+  static uint32_t add(uint32_t left, uint32_t right) {
+    const uint32_t sum = left + right;
+
+    return sum >= MOD ? sum - MOD : sum;
+  }
+
+  static uint32_t sub(uint32_t left, uint32_t right) {
+    return left >= right ? left - right : left + MOD - right;
+  }
+
+  // table[half + j] = w^j for the primitive (2 * half)-th root of unity w, for every power of two half < size.
+  // Each thread fills its part of every level from w^first on.
+  static void fill_roots(uint32_t *table, size_t size, bool inverse, const Share &share) {
+    for (size_t half = 1; half < size; half *= 2) {
+      uint32_t unit = power_mod(ROOT, (MOD - 1) / (2 * half), MOD);
+
+      if (inverse) {
+        unit = power_mod(unit, MOD - 2, MOD);
+      }
+
+      const size_t first = share.first(half);
+      const size_t last = share.last(half);
+      if (first < last) {
+        table[half + first] = power_mod(unit, first, MOD);
+      }
+      for (size_t idx = first + 1; idx < last; ++idx) {
+        table[half + idx] = mul(table[half + idx - 1], unit);
+      }
+    }
+  }
+
+  // One decimation in frequency stage: butterflies [first, last) of every block of 2 * half.
+  static void forward_stage(uint32_t *data, size_t size, size_t half, const uint32_t *twiddles, size_t first, size_t last) {
+    for (size_t start = 0; start < size; start += 2 * half) {
+      uint32_t *low = data + start;
+      uint32_t *high = low + half;
+
+      for (size_t idx = first; idx < last; ++idx) {
+        const uint32_t first_value = low[idx];
+        const uint32_t second_value = high[idx];
+
+        low[idx] = add(first_value, second_value);
+        high[idx] = mul(sub(first_value, second_value), twiddles[idx]);
+      }
+    }
+  }
+
+  // One decimation in time stage: butterflies [first, last) of every block of 2 * half.
+  static void inverse_stage(uint32_t *data, size_t size, size_t half, const uint32_t *twiddles, size_t first, size_t last) {
+    for (size_t start = 0; start < size; start += 2 * half) {
+      uint32_t *low = data + start;
+      uint32_t *high = low + half;
+
+      for (size_t idx = first; idx < last; ++idx) {
+        const uint32_t first_value = low[idx];
+        const uint32_t second_value = mul(high[idx], twiddles[idx]);
+
+        low[idx] = add(first_value, second_value);
+        high[idx] = sub(first_value, second_value);
+      }
+    }
+  }
+
+  // Size of the independent blocks a transform falls into once threads can take whole ones: size / 2^k with
+  // 2^k the first power of two reaching threads.
+  static size_t block_size(size_t size, size_t threads) {
+    size_t blocks = 1;
+    while (blocks < threads && blocks < size) {
+      blocks *= 2;
+    }
+
+    return size / blocks;
+  }
+
+  // Decimation in frequency: natural order in, bit-reversed order out.
+  // The first stages, where blocks are fewer than threads, split each block's butterflies between the team, and
+  // the remaining stages run as independent transforms of whole blocks. Alone, a thread takes the whole transform.
+  static void forward(uint32_t *data, size_t size, const uint32_t *roots, const Share &share) {
+    const size_t block = block_size(size, share.threads);
+
+    for (size_t half = size / 2; half >= block; half /= 2) {
+      forward_stage(data, size, half, roots + half, share.first(half), share.last(half));
+      share.sync();
+    }
+    for (size_t idx = share.first(size / block); idx < share.last(size / block); ++idx) {
+      for (size_t half = block / 2; half > 0; half /= 2) {
+        forward_stage(data + idx * block, block, half, roots + half, 0, half);
+      }
+    }
+  }
+
+  // Decimation in time with inverse roots: bit-reversed order in, natural order out, not yet scaled by 1 / size.
+  // The team splits the work as in forward, in the opposite order.
+  static void inverse(uint32_t *data, size_t size, const uint32_t *roots, const Share &share) {
+    const size_t block = block_size(size, share.threads);
+
+    for (size_t idx = share.first(size / block); idx < share.last(size / block); ++idx) {
+      for (size_t half = 1; half < block; half *= 2) {
+        inverse_stage(data + idx * block, block, half, roots + half, 0, half);
+      }
+    }
+    for (size_t half = block; half < size; half *= 2) {
+      share.sync();
+      inverse_stage(data, size, half, roots + half, share.first(half), share.last(half));
+    }
+  }
+
+  // Cyclic convolution of left and right modulo MOD, stored in result[0, size), as one share of the team.
+  // other and roots are scratch space of size words, other unused for a square. Every thread has to call this,
+  // and result is complete once they have synced.
+  static void convolve(uint32_t *result, uint32_t *other, uint32_t *roots, size_t size, const Limb *left, size_t left_size, const Limb *right, size_t right_size, const Share &share) {
+    // A square needs only one forward transform.
+    const bool square = left == right && left_size == right_size;
+
+    for (size_t idx = share.first(size); idx < share.last(size); ++idx) {
+      result[idx] = idx < left_size ? static_cast<uint32_t>(left[idx]) % MOD : 0;
+      if (!square) {
+        other[idx] = idx < right_size ? static_cast<uint32_t>(right[idx]) % MOD : 0;
+      }
+    }
+    fill_roots(roots, size, false, share);
+    share.sync();
+
+    forward(result, size, roots, share);
+    if (!square) {
+      forward(other, size, roots, share);
+    }
+    share.sync();
+
+    const uint32_t *factors = square ? result : other;
+    for (size_t idx = share.first(size); idx < share.last(size); ++idx) {
+      result[idx] = mul(result[idx], factors[idx]);
+    }
+    fill_roots(roots, size, true, share);
+    share.sync();
+
+    inverse(result, size, roots, share);
+    share.sync();
+
+    const uint32_t scale = power_mod(static_cast<uint32_t>(size % MOD), MOD - 2, MOD);
+    for (size_t idx = share.first(size); idx < share.last(size); ++idx) {
+      result[idx] = mul(result[idx], scale);
+    }
+  }
+};
+
+// Three primes whose product (~7.1e26) exceeds every convolution term, at most 2^24 * (BASE - 1)^2 < 2^88.
+using NttPrime1 = Ntt<2013265921, 31, 27>;
+using NttPrime2 = Ntt<754974721, 11, 24>;
+using NttPrime3 = Ntt<469762049, 3, 26>;
+
+constexpr size_t NTT_MAX_SIZE = NttPrime2::max_size;
+
+// result[position, size) += value
+void add_carry(Limb *result, size_t size, size_t position, uint64_t value) {
+  for (; value != 0 && position < size; ++position) {
+    value += static_cast<uint32_t>(result[position]);
+    result[position] = static_cast<Limb>(value % BASE);
+    value /= BASE;
+  }
+}
+
+// Multi-prime NTT product, the three residues of each term are recombined with Garner's algorithm.
+// With threads > 1 the transforms are shared out as described in Ntt, and the recombination runs on contiguous
+// ranges of the result whose outgoing carries are added in afterwards.
+void mul_ntt(Limb *result, const Limb *left, size_t left_size, const Limb *right, size_t right_size, size_t threads) {
+  constexpr uint64_t p1 = NttPrime1::mod;
+  constexpr uint64_t p2 = NttPrime2::mod;
+  constexpr uint64_t p3 = NttPrime3::mod;
+  constexpr uint32_t p1_inverse_mod_p2 = power_mod(p1 % p2, p2 - 2, p2);
+  constexpr uint32_t p1p2_inverse_mod_p3 = power_mod(p1 * p2 % p3, p3 - 2, p3);
+  constexpr uint64_t p1p2 = p1 * p2;
+  constexpr uint64_t p1p2_limbs[3] = { p1p2 % BASE, p1p2 / BASE % BASE, p1p2 / BASE / BASE };
+
+  const size_t result_size = left_size + right_size;
+  size_t size = 1;
+
+  while (size < result_size - 1) {
+    size *= 2;
+  }
+
+  const bool square = left == right && left_size == right_size;
+  SmallVector<uint32_t> residues((square ? 4 : 5) * size);
+  uint32_t *r1 = residues.begin();
+  uint32_t *r2 = r1 + size;
+  uint32_t *r3 = r2 + size;
+  uint32_t *roots = r3 + size;
+  uint32_t *other = roots + size;
+
+  // Writes result[first, last) and returns the carries out of it, into limbs last and last + 1.
+  const auto recombine = [&](size_t first, size_t last) -> std::pair<uint64_t, uint64_t> {
+    uint64_t carry = 0;// added at the current limb
+    uint64_t carry_next = 0;// added at the next limb
+
+    for (size_t idx = first; idx < last; ++idx) {
+      uint64_t term0 = 0;
+      uint64_t term1 = 0;
+      uint64_t term2 = 0;
+
+      if (idx < result_size - 1) {
+        // term = r1 + p1 * t2 + p1p2 * t3
+        const uint64_t t2 = NttPrime2::mul(NttPrime2::sub(r2[idx], static_cast<uint32_t>(r1[idx] % p2)), p1_inverse_mod_p2);
+        const uint64_t low = r1[idx] + p1 * t2;
+        const uint64_t t3 = NttPrime3::mul(NttPrime3::sub(r3[idx], static_cast<uint32_t>(low % p3)), p1p2_inverse_mod_p3);
+
+        term0 = low % BASE + t3 * p1p2_limbs[0];
+        term1 = low / BASE + t3 * p1p2_limbs[1];
+        term2 = t3 * p1p2_limbs[2];
+      }
+
+      const uint64_t value = carry + term0;
+
+      result[idx] = static_cast<Limb>(value % BASE);
+      carry = carry_next + term1 + value / BASE;
+      carry_next = term2;
+    }
+
+    return { carry, carry_next };
+  };
+
+  // The team is started once for the three convolutions and the recombination.
+  const size_t ranges = std::max<size_t>(threads, 1);
+  std::vector<std::pair<uint64_t, uint64_t>> carries(ranges);
+  run_team(ranges, [&](const Share &share) {
+    NttPrime1::convolve(r1, other, roots, size, left, left_size, right, right_size, share);
+    share.sync();
+    NttPrime2::convolve(r2, other, roots, size, left, left_size, right, right_size, share);
+    share.sync();
+    NttPrime3::convolve(r3, other, roots, size, left, left_size, right, right_size, share);
+    share.sync();
+    carries[share.index] = recombine(share.first(result_size), share.last(result_size));
+  });
+  for (size_t range = 1; range < ranges; ++range) {
+    const size_t position = range * result_size / ranges;
+    add_carry(result, result_size, position, carries[range - 1].first);
+    add_carry(result, result_size, position + 1, carries[range - 1].second);
+  }
+}
+
+}// namespace
+
+MulThresholds mul_thresholds = { KARATSUBA_THRESHOLD, TOOM3_THRESHOLD, NTT_THRESHOLD, TOOM4_THRESHOLD, SQR_KARATSUBA_THRESHOLD };
+
+void mul(Limb *result, const Limb *left, size_t left_size, const Limb *right, size_t right_size) {
+  if (left == right && left_size == right_size) {
+    sqr(result, left, left_size);
+    return;
+  }
+  if (left_size < right_size) {
+    std::swap(left, right);
+    std::swap(left_size, right_size);
+  }
+
+  if (right_size < mul_thresholds.karatsuba) {
+    mul_basecase(result, left, left_size, right, right_size);
+  } else if (right_size >= mul_thresholds.ntt && left_size + right_size <= NTT_MAX_SIZE) {
+    mul_ntt(result, left, left_size, right, right_size, 1);
+  } else if (right_size <= (left_size + 1) / 2) {
+    mul_unbalanced(result, left, left_size, right, right_size, 1);
+  } else if (right_size < mul_thresholds.toom3) {
+    karatsuba(result, left, left_size, right, right_size);
+  } else if (right_size <= 2 * ((left_size + 2) / 3)) {
+    toom32(result, left, left_size, right, right_size);
+  } else if (right_size < mul_thresholds.toom4) {
+    toom33(result, left, left_size, right, right_size);
+  } else {
+    toom44(result, left, left_size, right, right_size, 1);
+  }
+}
+
+void sqr(Limb *result, const Limb *ptr, size_t size) {
+  if (size < mul_thresholds.sqr_karatsuba) {
+    sqr_basecase(result, ptr, size);
+  } else if (size >= mul_thresholds.ntt && 2 * size <= NTT_MAX_SIZE) {
+    mul_ntt(result, ptr, size, ptr, size, 1);
+  } else if (size < mul_thresholds.toom3) {
+    sqr_karatsuba(result, ptr, size);
+  } else if (size < mul_thresholds.toom4) {
+    sqr_toom3(result, ptr, size);
+  } else {
+    sqr_toom4(result, ptr, size);
+  }
+}
+
+void mul_parallel(Limb *result, const Limb *left, size_t left_size, const Limb *right, size_t right_size, size_t threads) {
+  if (left_size < right_size) {
+    std::swap(left, right);
+    std::swap(left_size, right_size);
+  }
+
+  if (threads <= 1 || right_size < PARALLEL_THRESHOLD) {
+    mul(result, left, left_size, right, right_size);
+  } else if (left_size + right_size <= NTT_MAX_SIZE) {
+    mul_ntt(result, left, left_size, right, right_size, threads);
+  } else if (right_size <= (left_size + 1) / 2) {
+    mul_unbalanced(result, left, left_size, right, right_size, threads);
+  } else {
+    toom44(result, left, left_size, right, right_size, threads);
+  }
+}
+
+}// namespace limbs
+
+Bigint multiply(const Bigint &left, const Bigint &right, size_t threads) {
+  if (threads == 0) {
+    threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  }
+
+  size_t left_size = left.number.size();
+  size_t right_size = right.number.size();
+  while (left_size > 0 && left.number[left_size - 1] == 0) {
+    --left_size;
+  }
+  while (right_size > 0 && right.number[right_size - 1] == 0) {
+    --right_size;
+  }
+  if (left_size == 0 || right_size == 0) {
+    return Bigint(left.get_allocator());
+  }
+
+  Bigint result(left.get_allocator());
+
+  result.number.resize(left_size + right_size);
+
+  limbs::mul_parallel(result.number.begin(), left.number.begin(), left_size, right.number.begin(), right_size, threads);
+
+  while (!result.number.empty() && result.number.back() == 0) {
+    result.number.pop_back();
+  }
+
+  result.positive = result.number.empty() || left.positive == right.positive;
+
+  return result;
+}
+
+Bigint Bigint::operator*(const Bigint &right) const {
+  if (number.empty() || right.number.empty()) {
+    return Bigint(get_allocator());
+  }
+
+  Bigint result(get_allocator());
+
+  result.number.resize(number.size() + right.number.size());
+
+  limbs::mul(result.number.begin(), number.begin(), number.size(), right.number.begin(), right.number.size());
+
+  while (!result.number.empty() && result.number.back() == 0) {
+    result.number.pop_back();
+  }
+
+  result.positive = result.number.empty() || positive == right.positive;
+
+  return result;
+}
+
+Bigint &Bigint::operator*=(const Bigint &right) {
+  *this = *this * right;
+
+  return *this;
+}
+
+Bigint &Bigint::square() {
+  positive = true;
+  if (number.empty()) {
+    return *this;
+  }
+
+  Bigint result(get_allocator());
+
+  result.number.resize(2 * number.size());
+
+  limbs::sqr(result.number.begin(), number.begin(), number.size());
+
+  while (!result.number.empty() && result.number.back() == 0) {
+    result.number.pop_back();
+  }
+
+  number = std::move(result.number);
+
+  return *this;
+}
+
+void Bigint::fused_multiply(const Limb *left, size_t left_size, const Limb *right, size_t right_size, bool product_positive) {
+  while (left_size > 0 && left[left_size - 1] == 0) {
+    --left_size;
+  }
+  while (right_size > 0 && right[right_size - 1] == 0) {
+    --right_size;
+  }
+  if (left_size == 0 || right_size == 0) {
+    return;
+  }
+  if (left_size < right_size) {
+    std::swap(left, right);
+    std::swap(left_size, right_size);
+  }
+
+  while (!number.empty() && number.back() == 0) {
+    number.pop_back();
+  }
+  if (number.empty()) {
+    positive = product_positive;
+  }
+
+  const bool add = positive == product_positive;
+  const bool aliased = left == number.begin() || right == number.begin();
+
+  // Long operands or operands living in this value's own limbs go through a product buffer,
+  // which still saves the temporary Bigint and the copy of the accumulator.
+  if (aliased || right_size >= limbs::KARATSUBA_THRESHOLD) {
+    SmallVector<Limb> product(left_size + right_size);
+
+    limbs::mul(product.begin(), left, left_size, right, right_size);
+
+    if (add) {
+      add_magnitude(product.begin(), left_size + right_size);
+    } else {
+      sub_magnitude(product.begin(), left_size + right_size);
+    }
+    return;
+  }
+
+  // Row by row, each row's carry or borrow is pushed into the limbs above it. Both magnitudes are
+  // below BASE^size, so the whole sum overflows at most once, and a subtraction that overflows leaves
+  // BASE^size - |result|, which is complemented back.
+  const size_t size = std::max(number.size(), left_size + right_size);
+  number.resize(size, 0);
+
+  uint32_t overflow = 0;
+  for (size_t idx = 0; idx < right_size; ++idx) {
+    Limb *row = number.begin() + idx;
+    const auto factor = static_cast<uint32_t>(right[idx]);
+
+    if (add) {
+      const auto carry = static_cast<Limb>(limbs::addmul_1(row, left, left_size, factor));
+      overflow += limbs::add_in_place(row + left_size, size - idx - left_size, &carry, 1);
+    } else {
+      const auto borrow = static_cast<Limb>(limbs::submul_1(row, left, left_size, factor));
+      overflow += limbs::sub_in_place(row + left_size, size - idx - left_size, &borrow, 1);
+    }
+  }
+
+  if (overflow != 0 && add) {
+    number.push_back(1);
+  } else if (overflow != 0) {
+    size_t idx = 0;
+    for (; number[idx] == 0; ++idx) {}
+    number[idx] = static_cast<Limb>(limbs::BASE - number[idx]);
+    for (++idx; idx < size; ++idx) {
+      number[idx] = static_cast<Limb>(limbs::BASE - 1 - number[idx]);
+    }
+    positive = !positive;
+  }
+
+  while (!number.empty() && number.back() == 0) {
+    number.pop_back();
+  }
+  if (number.empty()) {
+    positive = true;
+  }
+}
+
+Bigint &Bigint::addmul(const Bigint &left, const Bigint &right) {
+  fused_multiply(left.number.begin(), left.number.size(), right.number.begin(), right.number.size(), left.positive == right.positive);
+
+  return *this;
+}
+
+Bigint &Bigint::submul(const Bigint &left, const Bigint &right) {
+  fused_multiply(left.number.begin(), left.number.size(), right.number.begin(), right.number.size(), left.positive != right.positive);
+
+  return *this;
+}
+
+Bigint &Bigint::addmul_1(const Bigint &left, int64_t value) {
+  std::array<Limb, 3> digits{};
+  const size_t digits_size = limbs::word_limbs(value, digits);
+
+  fused_multiply(left.number.begin(), left.number.size(), digits.data(), digits_size, left.positive == (value > 0));
+
+  return *this;
+}
+
+Bigint &Bigint::submul_1(const Bigint &left, int64_t value) {
+  std::array<Limb, 3> digits{};
+  const size_t digits_size = limbs::word_limbs(value, digits);
+
+  fused_multiply(left.number.begin(), left.number.size(), digits.data(), digits_size, left.positive != (value > 0));
+
+  return *this;
+}
+
+}// namespace BigMath
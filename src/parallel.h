@@ -0,0 +1,152 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <vector>
+
+// Thread teams for the parallel multiplication, shared by the Bigint translation units.
+namespace BigMath::limbs {
+
+// Runs task(first, last) on count items split into up to threads contiguous shares, the calling thread taking
+// the first share itself.
+template<typename Task>
+void parallel_for(size_t count, size_t threads, const Task &task) {
+  threads = std::min(threads, count);
+  if (threads <= 1) {
+    task(size_t{ 0 }, count);
+    return;
+  }
+
+  std::vector<std::future<void>> shares;
+  shares.reserve(threads - 1);
+  for (size_t share = 1; share < threads; ++share) {
+    shares.push_back(std::async(std::launch::async, [&task, share, count, threads] {
+      task(share * count / threads, (share + 1) * count / threads);
+    }));
+  }
+  task(size_t{ 0 }, count / threads);
+  for (std::future<void> &share : shares) {
+    share.get();
+  }
+}
+
+// Holds the threads of a team until all of them have arrived, then lets them go on together. Once cancelled,
+// because a member failed and will never arrive, every wait throws Cancelled instead of blocking.
+class Barrier {
+public:
+  struct Cancelled {};
+
+  explicit Barrier(size_t count) : count(count) {}
+
+  void wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (cancelled) {
+      throw Cancelled();
+    }
+
+    const size_t current = generation;
+    if (++arrived == count) {
+      arrived = 0;
+      ++generation;
+      condition.notify_all();
+      return;
+    }
+    condition.wait(lock, [this, current] { return generation != current || cancelled; });
+    if (generation == current) {
+      throw Cancelled();
+    }
+  }
+
+  void cancel() {
+    const std::lock_guard<std::mutex> lock(mutex);
+    cancelled = true;
+    condition.notify_all();
+  }
+
+private:
+  std::mutex mutex;
+  std::condition_variable condition;
+  size_t count;
+  size_t arrived = 0;
+  size_t generation = 0;
+  bool cancelled = false;
+};
+
+// One thread's place in a team started by run_team.
+struct Share {
+  size_t index;
+  size_t threads;
+  Barrier *barrier;
+
+  // This thread's contiguous part of count items
+  [[nodiscard]] size_t first(size_t count) const {
+    return index * count / threads;
+  }
+  [[nodiscard]] size_t last(size_t count) const {
+    return (index + 1) * count / threads;
+  }
+
+  // Waits for the rest of the team, so what any thread wrote before is visible to all of them after.
+  void sync() const {
+    if (threads > 1) {
+      barrier->wait();
+    }
+  }
+};
+
+// Runs task(share) once on each of threads threads, the calling thread being share 0. The threads are started
+// once for the whole task, which moves from one phase to the next with Share::sync.
+// The first exception thrown by a member, or by starting a thread, cancels the barrier so the others stop at
+// their next sync, and is rethrown once all of them have returned.
+template<typename Task>
+void run_team(size_t threads, const Task &task) {
+  threads = std::max<size_t>(threads, 1);
+  Barrier barrier(threads);
+  std::mutex failure_mutex;
+  std::exception_ptr failure;
+
+  const auto fail = [&](std::exception_ptr error) {
+    {
+      const std::lock_guard<std::mutex> lock(failure_mutex);
+      if (!failure) {
+        failure = std::move(error);
+      }
+    }
+    barrier.cancel();
+  };
+  const auto member = [&](size_t index) {
+    try {
+      task(Share{ index, threads, &barrier });
+    } catch (const Barrier::Cancelled &) {
+      // Another member failed first
+    } catch (...) {
+      fail(std::current_exception());
+    }
+  };
+
+  std::vector<std::future<void>> members;
+  try {
+    members.reserve(threads - 1);
+    for (size_t index = 1; index < threads; ++index) {
+      members.push_back(std::async(std::launch::async, member, index));
+    }
+  } catch (...) {
+    fail(std::current_exception());
+  }
+  if (members.size() == threads - 1) {
+    member(0);
+  }
+  for (std::future<void> &started : members) {
+    started.wait();
+  }
+
+  if (failure) {
+    std::rethrow_exception(failure);
+  }
+}
+
+}// namespace BigMath::limbs
@@ -0,0 +1,215 @@
+#include "bigint.h"
+#include "limbs.h"
+
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace BigMath {
+
+namespace {
+
+// Factors per leaf of a product tree. Word sized factors are packed into single words before touching a Bigint.
+constexpr size_t PRODUCT_TREE_LEAF = 32;
+
+// binomial(n, k) divides a range product by k! once k is below n / BINOMIAL_RATIO, rather than sieving up to n.
+constexpr uint64_t BINOMIAL_RATIO = 16;
+
+// factorial(n) multiplies 2 * 3 * ... * n directly below this.
+constexpr uint64_t FACTORIAL_DIRECT = 64;
+
+// The thread count of the public functions, 0 meaning one per core like multiply's.
+size_t team_size(size_t threads) {
+  return threads != 0 ? threads : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+Bigint from_word(uint64_t value) {
+  Bigint result(static_cast<int64_t>(value / limbs::BASE));
+  result *= static_cast<int64_t>(limbs::BASE);
+  result += static_cast<int64_t>(value % limbs::BASE);
+
+  return result;
+}
+
+// Product of values[0, count), as many at a time as fit a word.
+Bigint multiply_words(const uint64_t *values, size_t count) {
+  Bigint result(1);
+  uint64_t word = 1;
+  for (size_t idx = 0; idx < count; ++idx) {
+    const uint64_t value = values[idx];
+    if (value != 0 && word <= INT64_MAX / value) {
+      word *= value;
+      continue;
+    }
+
+    result *= from_word(word);
+    word = value;
+  }
+
+  return result *= from_word(word);
+}
+
+// Product of leaf(first, last) over [first, last) split in halves. The halves of a node with threads > 1 are
+// computed side by side, each with half of the threads, and multiplied with all of them.
+template<typename Leaf>
+Bigint product_tree(size_t first, size_t last, size_t threads, const Leaf &leaf) {
+  if (last - first <= PRODUCT_TREE_LEAF) {
+    return leaf(first, last);
+  }
+
+  const size_t middle = first + (last - first) / 2;
+  if (threads <= 1) {
+    return product_tree(first, middle, 1, leaf) * product_tree(middle, last, 1, leaf);
+  }
+
+  std::future<Bigint> high = std::async(std::launch::async, [&] {
+    return product_tree(middle, last, threads - threads / 2, leaf);
+  });
+  const Bigint low = product_tree(first, middle, threads / 2, leaf);
+
+  return multiply(low, high.get(), threads);
+}
+
+Bigint product_words(const std::vector<uint64_t> &values, size_t threads) {
+  return product_tree(0, values.size(), threads,
+    [&values](size_t first, size_t last) { return multiply_words(values.data() + first, last - first); });
+}
+
+// Primes up to limit, from a sieve over the odd numbers
+std::vector<uint64_t> primes_up_to(uint64_t limit) {
+  std::vector<uint64_t> primes;
+  if (limit < 2) {
+    return primes;
+  }
+
+  primes.push_back(2);
+  std::vector<bool> composite((limit - 1) / 2);// composite[i] for 2 * i + 3
+  for (uint64_t idx = 0; idx < composite.size(); ++idx) {
+    if (composite[idx]) {
+      continue;
+    }
+
+    const uint64_t prime = 2 * idx + 3;
+    primes.push_back(prime);
+    if (prime > limit / prime) {
+      continue;
+    }
+    for (uint64_t multiple = prime * prime; multiple <= limit; multiple += 2 * prime) {
+      composite[(multiple - 3) / 2] = true;
+    }
+  }
+
+  return primes;
+}
+
+// n! / (floor(n / 2)!)^2, the prime swing: each prime p <= n appears with exponent sum_j (floor(n / p^j) mod 2),
+// so its power is at most n.
+Bigint swing(uint64_t n, const std::vector<uint64_t> &primes, size_t threads) {
+  std::vector<uint64_t> powers;
+  for (const uint64_t prime : primes) {
+    if (prime > n) {
+      break;
+    }
+
+    uint64_t power = 1;
+    for (uint64_t quotient = n / prime; quotient > 0; quotient /= prime) {
+      if (quotient % 2 != 0) {
+        power *= prime;
+      }
+    }
+    if (power > 1) {
+      powers.push_back(power);
+    }
+  }
+
+  return product_words(powers, threads);
+}
+
+}// namespace
+
+Bigint product(const std::vector<Bigint> &factors, size_t threads) {
+  return product_tree(0, factors.size(), team_size(threads), [&factors](size_t first, size_t last) {
+    Bigint result(1);
+    for (size_t idx = first; idx < last; ++idx) {
+      result *= factors[idx];
+    }
+
+    return result;
+  });
+}
+
+Bigint product_range(uint64_t low, uint64_t high, size_t threads) {
+  if (low > high) {
+    return Bigint(1);
+  }
+  if (low == 0) {
+    return Bigint();
+  }
+
+  return product_tree(0, high - low + 1, team_size(threads), [low](size_t first, size_t last) {
+    uint64_t values[PRODUCT_TREE_LEAF];
+    for (size_t idx = first; idx < last; ++idx) {
+      values[idx - first] = low + idx;
+    }
+
+    return multiply_words(values, last - first);
+  });
+}
+
+// n! = (floor(n / 2)!)^2 * swing(n), unrolled from the smallest floor(n / 2^i) upward. Only the swings are
+// products of many factors, and their primes come from one sieve up to n.
+Bigint factorial(uint64_t n, size_t threads) {
+  threads = team_size(threads);
+  if (n < FACTORIAL_DIRECT) {
+    return product_range(2, n, threads);
+  }
+
+  const std::vector<uint64_t> primes = primes_up_to(n);
+  uint32_t levels = 0;
+  while ((n >> levels) >= FACTORIAL_DIRECT) {
+    ++levels;
+  }
+
+  Bigint result = product_range(2, n >> levels, threads);
+  for (uint32_t level = levels; level-- > 0;) {
+    result = multiply(result, result, threads);
+    result = multiply(result, swing(n >> level, primes, threads), threads);
+  }
+
+  return result;
+}
+
+// The exponent of p in binomial(n, k) is sum_j (floor(n / p^j) - floor(k / p^j) - floor((n - k) / p^j)), the number
+// of carries when adding k and n - k in base p (Kummer), so its power is at most n.
+Bigint binomial(uint64_t n, uint64_t k, size_t threads) {
+  threads = team_size(threads);
+  if (k > n) {
+    return Bigint();
+  }
+  k = std::min(k, n - k);
+  if (k == 0) {
+    return Bigint(1);
+  }
+  if (k < n / BINOMIAL_RATIO) {
+    return product_range(n - k + 1, n, threads) / factorial(k, threads);
+  }
+
+  std::vector<uint64_t> powers;
+  for (const uint64_t prime : primes_up_to(n)) {
+    uint64_t power = 1;
+    for (uint64_t top = n / prime, left = k / prime, right = (n - k) / prime; top > 0;
+         top /= prime, left /= prime, right /= prime) {
+      for (uint64_t carry = top - left - right; carry > 0; --carry) {
+        power *= prime;
+      }
+    }
+    if (power > 1) {
+      powers.push_back(power);
+    }
+  }
+
+  return product_words(powers, threads);
+}
+
+}// namespace BigMath
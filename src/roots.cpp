@@ -0,0 +1,307 @@
+#include "bigint.h"
+#include "limbs.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace BigMath {
+
+namespace {
+
+constexpr double LOG10_2 = 0.30102999566398119521;
+
+// Bit i is set when i is a square modulo m, m <= 64.
+constexpr uint64_t square_mask(uint64_t m) {
+  uint64_t mask = 0;
+  for (uint64_t i = 0; i < m; ++i) {
+    mask |= uint64_t{ 1 } << (i * i % m);
+  }
+
+  return mask;
+}
+
+struct SquareFilter {
+  uint64_t modulus;
+  uint64_t mask;
+};
+
+// 64 and 25 divide a decimal BASE, so these two are read off the lowest limb. Binary limbs take n mod 25 in a pass of
+// its own.
+constexpr SquareFilter SQUARES_MOD_64 = { 64, square_mask(64) };
+constexpr SquareFilter SQUARES_MOD_25 = { 25, square_mask(25) };
+
+// Moduli whose product, SQUARE_FILTER_PRODUCT, still fits in a word, so a single pass over the limbs serves them all.
+// Together with the two above they reject all but about 1 in 50000 non-squares.
+constexpr std::array<SquareFilter, 12> SQUARE_FILTERS = { { { 63, square_mask(63) }, { 11, square_mask(11) },
+  { 13, square_mask(13) }, { 17, square_mask(17) }, { 19, square_mask(19) }, { 23, square_mask(23) },
+  { 29, square_mask(29) }, { 31, square_mask(31) }, { 37, square_mask(37) }, { 41, square_mask(41) },
+  { 43, square_mask(43) }, { 47, square_mask(47) } } };
+constexpr uint64_t SQUARE_FILTER_PRODUCT = 184466934776547423ULL;
+
+bool passes(const SquareFilter &filter, uint64_t value) {
+  return ((filter.mask >> (value % filter.modulus)) & 1U) != 0;
+}
+
+// base^exponent mod modulus for modulus < 2^32.
+uint64_t pow_mod(uint64_t base, uint64_t exponent, uint64_t modulus) {
+  uint64_t result = 1 % modulus;
+  base %= modulus;
+  for (; exponent != 0; exponent >>= 1U) {
+    if ((exponent & 1U) != 0) {
+      result = result * base % modulus;
+    }
+    base = base * base % modulus;
+  }
+
+  return result;
+}
+
+// Miller-Rabin with the bases 2, 7 and 61, which has no strong pseudoprimes below 2^32.
+bool is_prime(uint64_t value) {
+  if (value < 2) {
+    return false;
+  }
+  for (const uint64_t small : { 2, 3, 5, 7, 11, 13, 61 }) {
+    if (value % small == 0) {
+      return value == small;
+    }
+  }
+
+  uint64_t odd = value - 1;
+  uint32_t twos = 0;
+  while (odd % 2 == 0) {
+    odd /= 2;
+    ++twos;
+  }
+
+  for (const uint64_t base : { 2, 7, 61 }) {
+    uint64_t x = pow_mod(base, odd, value);
+    if (x == 1 || x == value - 1) {
+      continue;
+    }
+    for (uint32_t i = 1; i < twos && x != value - 1; ++i) {
+      x = x * x % value;
+    }
+    if (x != value - 1) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+}// namespace
+
+// Newton iteration for floor(n^(1/k)). The starting value is the root of the top half of n, shifted back, so the
+// recursion does the early iterations on numbers a fraction of the size and the last ones only correct the low half.
+struct Roots {
+  static size_t size(const Bigint &x) {
+    size_t limbs = x.number.size();
+    while (limbs > 0 && x.number[limbs - 1] == 0) {
+      --limbs;
+    }
+
+    return limbs;
+  }
+
+  // floor(|x| / BASE^from)
+  static Bigint high(const Bigint &x, size_t from) {
+    Bigint result(x.get_allocator());
+    const size_t limbs = size(x);
+    if (limbs > from) {
+      result.number.resize(limbs - from);
+      std::copy(x.number.begin() + from, x.number.begin() + limbs, result.number.begin());
+    }
+
+    return result;
+  }
+
+  // log10(|x|) for x non-zero, from its three leading limbs
+  static double log10(const Bigint &x) {
+    const size_t limbs = size(x);
+    const size_t leading_limbs = std::min<size_t>(limbs, 3);
+    double leading = 0;
+    for (size_t i = limbs; i > limbs - leading_limbs; --i) {
+      leading = leading * limbs::BASE + x.number[i - 1];
+    }
+
+    return std::log10(leading) + std::log10(static_cast<double>(limbs::BASE)) * static_cast<double>(limbs - leading_limbs);
+  }
+
+  // False when x, with x_size limbs and non-zero, is not a square modulo one of the filter moduli
+  static bool may_be_square(const Bigint &x, size_t x_size) {
+    const auto low = static_cast<uint64_t>(x.number[0]);
+    const uint64_t low_25 = limbs::BASE % 25 == 0 ? low : limbs::mod_1(x.number.begin(), x_size, limbs::Divisor(25));
+    if (!passes(SQUARES_MOD_64, low) || !passes(SQUARES_MOD_25, low_25)) {
+      return false;
+    }
+
+    const uint64_t remainder = limbs::mod_1(x.number.begin(), x_size, limbs::Divisor(SQUARE_FILTER_PRODUCT));
+    return std::all_of(SQUARE_FILTERS.begin(), SQUARE_FILTERS.end(),
+      [remainder](const SquareFilter &filter) { return passes(filter, remainder); });
+  }
+
+  // floor(n^(1/k)) for n > 1 and k > 1
+  static Bigint root(const Bigint &n, uint64_t k) {
+    const double log = log10(n);
+    if (static_cast<double>(k) * LOG10_2 > log + 1e-6) {// 2^k > n
+      return Bigint(1, n.get_allocator());
+    }
+
+    // The iteration below needs a starting value at or above the root.
+    Bigint x(n.get_allocator());
+    const size_t root_limbs = (size(n) + k - 1) / k;
+    if (root_limbs <= (limbs::BINARY ? 1 : 2)) {
+      // Below 10^18 (2^32 for binary limbs), a double is off by far less than the margin added.
+      const double estimate = std::pow(10.0, log / static_cast<double>(k));
+      x = Bigint(static_cast<int64_t>(estimate * (1 + 1e-8)) + 2, n.get_allocator());
+    } else {
+      // (t + 1)^k > floor(n / BASE^(k * shift)) when t is that number's root, so (t + 1) * BASE^shift is above n's.
+      const size_t shift = std::max<size_t>((root_limbs - 1) / 2, 1);
+      x = root(high(n, k * shift), k);
+      x += 1;
+      const size_t x_size = x.number.size();
+      x.number.resize(x_size + shift);
+      std::copy_backward(x.number.begin(), x.number.begin() + x_size, x.number.end());
+      std::fill(x.number.begin(), x.number.begin() + shift, 0);
+    }
+
+    // From above, x decreases strictly until it reaches the root.
+    const Bigint degree(static_cast<int64_t>(k), n.get_allocator());
+    const Bigint lower_degree(static_cast<int64_t>(k - 1), n.get_allocator());
+    while (true) {
+      Bigint power(x);
+      power.pow(k - 1);
+      Bigint next = x * lower_degree;
+      next += n / power;
+      next /= degree;
+      if (next >= x) {
+        return x;
+      }
+      x = std::move(next);
+    }
+  }
+};
+
+Bigint isqrt(const Bigint &value) {
+  return iroot(value, 2);
+}
+
+Bigint iroot(const Bigint &value, uint64_t k) {
+  if (k == 0) {
+    throw std::invalid_argument("Root degree must be positive");
+  }
+  const bool negative = value.is_negative() && Roots::size(value) != 0;
+  if (negative && k % 2 == 0) {
+    throw std::invalid_argument("Even root of a negative number");
+  }
+
+  Bigint magnitude(value);
+  magnitude.abs();
+  if (Roots::size(magnitude) == 0) {
+    return magnitude;
+  }
+  if (k == 1 || magnitude == Bigint(1)) {
+    return value;
+  }
+
+  Bigint result = Roots::root(magnitude, k);
+  if (negative) {
+    result.flip_sign();
+  }
+
+  return result;
+}
+
+bool is_perfect_square(const Bigint &value) {
+  const size_t limbs = Roots::size(value);
+  if (limbs == 0) {
+    return true;
+  }
+  if (value.is_negative()) {
+    return false;
+  }
+
+  return Roots::may_be_square(value, limbs) && isqrt(value).square() == value;
+}
+
+// A k-th power for a prime k is also one modulo every prime q = 1 mod k, where only 1 in k residues are. The small
+// degrees are screened with a few such q, the large ones by how close the root's double estimate is to an integer,
+// and only the candidates left are checked exactly.
+bool is_perfect_power(const Bigint &value) {
+  Bigint magnitude(value);
+  magnitude.abs();
+  if (Roots::size(magnitude) == 0 || magnitude == Bigint(1)) {
+    return true;
+  }
+  if (!value.is_negative() && is_perfect_square(magnitude)) {
+    return true;
+  }
+
+  // Roots below ROUNDING_LIMIT are told apart from integers by their estimate alone.
+  constexpr double ROUNDING_LIMIT = 1e6;
+  constexpr uint64_t WITNESS_LIMIT = uint64_t{ 1 } << 32U;
+  const double log = Roots::log10(magnitude);
+  const auto max_degree = static_cast<uint64_t>(log / LOG10_2) + 1;// 2^k > n from there
+  const auto exact = [&magnitude](Bigint root, uint64_t k) { return root.pow(k) == magnitude; };
+
+  std::vector<bool> composite(max_degree + 1);
+  std::vector<uint64_t> degrees;// odd primes whose roots are too large to round
+  std::vector<int64_t> witnesses;
+  std::vector<size_t> witness_counts;
+  for (uint64_t k = 3; k <= max_degree; k += 2) {
+    if (composite[k]) {
+      continue;
+    }
+    for (uint64_t multiple = k * k; multiple <= max_degree; multiple += 2 * k) {
+      composite[multiple] = true;
+    }
+
+    const double estimate = std::pow(10.0, log / static_cast<double>(k));
+    if (estimate < ROUNDING_LIMIT) {
+      const double nearest = std::round(estimate);
+      if (std::abs(estimate - nearest) < 1e-4 && exact(Bigint(static_cast<int64_t>(nearest), value.get_allocator()), k)) {
+        return true;
+      }
+      continue;
+    }
+
+    // Enough q for a non-power to pass them all with a chance of about 2^-20
+    size_t count = 0;
+    uint32_t bits = 0;
+    for (uint64_t top = k; top != 0; top >>= 1U) {
+      ++bits;
+    }
+    for (uint64_t q = 2 * k + 1; q < WITNESS_LIMIT && count < 1 + 20 / bits; q += 2 * k) {
+      if (is_prime(q)) {
+        witnesses.push_back(static_cast<int64_t>(q));
+        ++count;
+      }
+    }
+    degrees.push_back(k);
+    witness_counts.push_back(count);
+  }
+
+  const std::vector<int64_t> residues = remainders(magnitude, witnesses);
+  size_t next = 0;
+  for (size_t i = 0; i < degrees.size(); ++i) {
+    const uint64_t k = degrees[i];
+    bool candidate = true;
+    for (size_t j = next; j < next + witness_counts[i] && candidate; ++j) {
+      const auto q = static_cast<uint64_t>(witnesses[j]);
+      const auto residue = static_cast<uint64_t>(residues[j]);
+      candidate = residue == 0 || pow_mod(residue, (q - 1) / k, q) == 1;
+    }
+    next += witness_counts[i];
+
+    if (candidate && exact(Roots::root(magnitude, k), k)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+}// namespace BigMath
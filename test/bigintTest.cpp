@@ -1,11 +1,89 @@
 #include <gtest/gtest.h>
 
 #include <climits>
+#include <cstdint>
 #include <fstream>
+#include <random>
+#include <thread>
 
 #include "bigint.h"
+#include "modcontext.h"
+
+#include "../src/limbs.h"
+#include "../src/parallel.h"
 
 using BigMath::Bigint;
+using BigMath::ModContext;
+using BigMath::binomial;
+using BigMath::factorial;
+using BigMath::product;
+using BigMath::product_range;
+
+namespace {
+
+std::string random_digits(std::mt19937 &generator, size_t length) {
+  std::uniform_int_distribution<int> digit(0, 9);
+  std::string digits(length, '0');
+
+  for (char &chr : digits) {
+    chr = static_cast<char>('0' + digit(generator));
+  }
+  digits[0] = static_cast<char>('1' + digit(generator) % 9);
+
+  return digits;
+}
+
+// Schoolbook product built only from single-limb multiplication and add_zeroes.
+Bigint reference_product(const Bigint &left, const std::string &right) {
+  Bigint result;
+
+  for (size_t end = right.size(), shift = 0; end > 0; shift += 9) {
+    const size_t begin = end > 9 ? end - 9 : 0;
+    result += (left * std::stoll(right.substr(begin, end - begin))).add_zeroes(shift);
+    end = begin;
+  }
+
+  return result;
+}
+
+// Forwards to the new/delete resource and counts the allocations made through it.
+class CountingResource : public std::pmr::memory_resource {
+public:
+  size_t allocations = 0;
+
+private:
+  void *do_allocate(size_t bytes, size_t alignment) override {
+    ++allocations;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void *ptr, size_t bytes, size_t alignment) override {
+    std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+  }
+
+  [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+};
+
+// Replaces the operand sizes at which multiplication changes algorithm for one scope, so that small operands
+// reach the tiers the defaults keep for huge ones.
+class ThresholdOverride {
+public:
+  explicit ThresholdOverride(const BigMath::limbs::MulThresholds &thresholds) : saved(BigMath::limbs::mul_thresholds) {
+    BigMath::limbs::mul_thresholds = thresholds;
+  }
+  ~ThresholdOverride() {
+    BigMath::limbs::mul_thresholds = saved;
+  }
+  ThresholdOverride(const ThresholdOverride &) = delete;
+  ThresholdOverride &operator=(const ThresholdOverride &) = delete;
+
+private:
+  BigMath::limbs::MulThresholds saved;
+};
+
+}// namespace
 
 TEST(ComparisonTests, ComparisonTests) {
   ASSERT_TRUE(Bigint(123) == Bigint(123));
@@ -53,6 +131,30 @@ TEST(SumationTests, SumationTests) {
   b += 999999999;
 
   EXPECT_TRUE(b == Bigint(1000000000));
+
+  // -INT64_MIN is not an int64_t
+  EXPECT_TRUE(Bigint(1) + INT64_MIN == Bigint("-9223372036854775807"));
+  EXPECT_TRUE(Bigint(-1) + INT64_MIN == Bigint("-9223372036854775809"));
+  EXPECT_TRUE(Bigint("9223372036854775808") + INT64_MIN == Bigint(0));
+
+  const Bigint nines(std::string(45, '9'));
+  const Bigint power("1" + std::string(45, '0'));
+
+  EXPECT_TRUE(nines + Bigint(1) == power);
+  EXPECT_TRUE(nines + 1 == power);
+  EXPECT_TRUE(Bigint(1) + nines == power);
+  EXPECT_TRUE(power + Bigint(1) == Bigint("1" + std::string(44, '0') + "1"));
+
+  // Lengths around the 8 and 16 limb vector blocks, with carries crossing block boundaries.
+  for (size_t digits = 9; digits <= 400; digits += 9) {
+    const Bigint all_nines(std::string(digits, '9'));
+    const Bigint next("1" + std::string(digits, '0'));
+
+    EXPECT_TRUE(all_nines + 1 == next);
+    EXPECT_TRUE(all_nines + all_nines + 2 == next * 2);
+    EXPECT_TRUE(next - 1 == all_nines);
+    EXPECT_TRUE(next - all_nines == Bigint(1));
+  }
 }
 
 TEST(SubtractionTests, SubtractionTests) {
@@ -89,6 +191,85 @@ TEST(SubtractionTests, SubtractionTests) {
   g -= 42309420844924;
 
   EXPECT_TRUE(g == Bigint(5));
+
+  EXPECT_TRUE(Bigint(1) - INT64_MIN == Bigint("9223372036854775809"));
+  EXPECT_TRUE(Bigint(-1) - INT64_MIN == Bigint("9223372036854775807"));
+  EXPECT_TRUE(Bigint(INT64_MIN) - INT64_MIN == Bigint(0));
+  EXPECT_FALSE((Bigint(INT64_MIN) - INT64_MIN).is_negative());
+
+  const Bigint nines(std::string(45, '9'));
+  const Bigint power("1" + std::string(45, '0'));
+
+  EXPECT_TRUE(power - Bigint(1) == nines);
+  EXPECT_TRUE(power - 1 == nines);
+  EXPECT_TRUE(Bigint(1) - power == -Bigint(nines));
+  EXPECT_TRUE(power - Bigint("1" + std::string(18, '0')) == Bigint(std::string(27, '9') + std::string(18, '0')));
+}
+
+TEST(SharedOperandTests, SharedOperandTests) {
+  const Bigint shared("-123456789012345678901234567890");
+  std::array<Bigint, 4> sums;
+  std::array<Bigint, 4> differences;
+  std::vector<std::thread> threads;
+
+  for (size_t idx = 0; idx < sums.size(); ++idx) {
+    threads.emplace_back([&, idx] {
+      for (int32_t step = 0; step < 2000; ++step) {
+        sums[idx] += shared;
+        differences[idx] -= shared;
+      }
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+
+  for (size_t idx = 0; idx < sums.size(); ++idx) {
+    EXPECT_TRUE(sums[idx] == shared * 2000);
+    EXPECT_TRUE(differences[idx] == shared * -2000);
+  }
+  EXPECT_TRUE(shared.is_negative());
+
+  Bigint a("999999999999999999");
+  a += a;
+  EXPECT_TRUE(a == Bigint("1999999999999999998"));
+  a -= a;
+  EXPECT_TRUE(a == Bigint() && !a.is_negative());
+
+  EXPECT_TRUE(Bigint("1000000000000000000") - Bigint("1000000000000000001") == Bigint(-1));
+  EXPECT_TRUE(Bigint(-5) - Bigint("-1000000000000000000") == Bigint("999999999999999995"));
+}
+
+TEST(RvalueOperatorTests, RvalueOperatorTests) {
+  CountingResource resource;
+  const Bigint::allocator_type allocator(&resource);
+  std::mt19937 generator(14);
+
+  const Bigint a(random_digits(generator, 900), allocator);
+  const Bigint b(random_digits(generator, 900), allocator);
+  const Bigint c(random_digits(generator, 900), allocator);
+  const Bigint d(random_digits(generator, 900), allocator);
+
+  Bigint expected = a;
+  expected += b;
+  expected += c;
+  expected += d;
+
+  resource.allocations = 0;
+  const Bigint sum = a + b + c + d;
+
+  EXPECT_TRUE(sum == expected);
+  EXPECT_TRUE(resource.allocations <= 2);
+
+  resource.allocations = 0;
+  const Bigint mixed = a - (b + c) - (d - a) + 5 - (Bigint(7) - d);
+
+  EXPECT_TRUE(mixed == a * 2 - b - c + 5 - 7);
+  EXPECT_TRUE(resource.allocations <= 4);
+
+  EXPECT_TRUE(Bigint(5) - Bigint(5) == Bigint() && !(Bigint(5) - Bigint(5)).is_negative());
+  EXPECT_TRUE(Bigint(3) - Bigint("-1000000000000") == Bigint("1000000000003"));
+  EXPECT_TRUE(Bigint(-3) + Bigint("1000000000000") == Bigint("999999999997"));
 }
 
 TEST(MultiplicationTests, MultiplicationTests) {
@@ -119,6 +300,168 @@ TEST(MultiplicationTests, MultiplicationTests) {
 
   EXPECT_TRUE(Bigint(454513) * 54234575622444 == Bigint("24650319669883889772"));
   EXPECT_TRUE(Bigint(454513) * LLONG_MAX == Bigint("4192142494586974716366991"));
+  EXPECT_TRUE(Bigint("999999999999999999") * 999999999999 == Bigint("999999999998999999000000000001"));
+  EXPECT_TRUE(Bigint(2) * LLONG_MIN == Bigint("-18446744073709551616"));
+}
+
+TEST(FusedMultiplyTests, FusedMultiplyTests) {
+  std::mt19937 generator(15);
+  const std::array<std::pair<size_t, size_t>, 4> sizes = { { { 30, 20 }, { 400, 9 }, { 900, 700 }, { 5, 2000 } } };
+
+  for (const auto &[left_digits, right_digits] : sizes) {
+    const Bigint left(random_digits(generator, left_digits));
+    const Bigint right = -Bigint(random_digits(generator, right_digits));
+
+    for (const Bigint &start : { Bigint(), Bigint(random_digits(generator, 50)), -Bigint(random_digits(generator, 1500)), left * right }) {
+      Bigint sum = start;
+      Bigint difference = start;
+      sum.addmul(left, right);
+      difference.submul(left, right);
+
+      EXPECT_TRUE(sum == start + left * right);
+      EXPECT_TRUE(difference == start - left * right);
+      EXPECT_FALSE(difference.is_negative() && difference == Bigint());
+
+      Bigint word_sum = start;
+      Bigint word_difference = start;
+      word_sum.addmul_1(left, -987654321987654321);
+      word_difference.submul_1(right, 123456789);
+
+      EXPECT_TRUE(word_sum == start + left * Bigint(-987654321987654321));
+      EXPECT_TRUE(word_difference == start - right * Bigint(123456789));
+    }
+  }
+
+  Bigint a("123456789123456789123456789");
+  a.addmul(a, a);
+
+  EXPECT_TRUE(a == Bigint("15241578780673678546105778404511509639079409873647310"));
+
+  a.submul_1(a, 1);
+
+  EXPECT_TRUE(a == Bigint() && !a.is_negative());
+}
+
+TEST(KaratsubaTests, KaratsubaTests) {
+  std::mt19937 generator(20201);
+  const std::array<std::pair<size_t, size_t>, 6> sizes = { {
+    { 400, 400 },
+    { 1000, 999 },
+    { 9000, 9000 },
+    { 5000, 400 },
+    { 3001, 1700 },
+    { 12345, 4567 },
+  } };
+
+  for (const auto &[left_digits, right_digits] : sizes) {
+    const std::string right = random_digits(generator, right_digits);
+    const Bigint left(random_digits(generator, left_digits));
+
+    EXPECT_TRUE(left * Bigint(right) == reference_product(left, right));
+    EXPECT_TRUE(Bigint(right) * left == reference_product(left, right));
+    EXPECT_TRUE(left * -Bigint(right) == -reference_product(left, right));
+  }
+
+  const Bigint nines(std::string(2000, '9'));
+  EXPECT_TRUE(nines * nines == reference_product(nines, std::string(2000, '9')));
+}
+
+TEST(ToomCookTests, ToomCookTests) {
+  // Shorter operands of 160 to 800 limbs, between the Toom-3 and the NTT thresholds: Toom-3 when the shorter one is
+  // over 2/3 of the longer, Toom-3/2 when it is between 1/2 and 2/3.
+  std::mt19937 generator(20202);
+  const std::array<std::pair<size_t, size_t>, 6> sizes = { {
+    { 1800, 1800 },
+    { 6500, 5000 },
+    { 7000, 7000 },
+    { 2700, 1600 },
+    { 4500, 2700 },
+    { 7100, 4000 },
+  } };
+
+  for (const auto &[left_digits, right_digits] : sizes) {
+    const std::string right = random_digits(generator, right_digits);
+    const Bigint left(random_digits(generator, left_digits));
+    const Bigint product = left * Bigint(right);
+
+    EXPECT_TRUE(product == reference_product(left, right));
+    EXPECT_TRUE(-Bigint(right) * left == -reference_product(left, right));
+
+    // Toom-4 from 160 limbs must agree with Toom-3
+    const ThresholdOverride toom4({ 48, 160, SIZE_MAX, 160, 64 });
+    EXPECT_TRUE(left * Bigint(right) == product);
+  }
+
+  for (const size_t digits : { 1500, 4000, 7100 }) {
+    const std::string text = random_digits(generator, digits);
+    Bigint number = -Bigint(text);
+
+    EXPECT_TRUE(number.square() == reference_product(Bigint(text), text));
+  }
+
+  const Bigint nines(std::string(6000, '9'));
+  EXPECT_TRUE(nines * nines == reference_product(nines, std::string(6000, '9')));
+}
+
+TEST(ToomFourTests, ToomFourTests) {
+  // By default Toom-4 only takes products too long for the NTT. Without the NTT and from 200 limbs on, it takes
+  // every product below whose shorter operand is over 2/3 of the longer one, and each block of the 1000 x 223 one.
+  const ThresholdOverride toom4({ 48, 160, SIZE_MAX, 200, 64 });
+  std::mt19937 generator(20204);
+  const std::array<std::pair<size_t, size_t>, 4> sizes = { {
+    { 2700, 2700 },
+    { 4000, 3000 },
+    { 3600, 2500 },
+    { 9000, 2000 },
+  } };
+
+  for (const auto &[left_digits, right_digits] : sizes) {
+    const std::string right = random_digits(generator, right_digits);
+    const Bigint left(random_digits(generator, left_digits));
+
+    EXPECT_TRUE(left * Bigint(right) == reference_product(left, right));
+    EXPECT_TRUE(left * -Bigint(right) == -reference_product(left, right));
+    EXPECT_TRUE(-left.clone() * -Bigint(right) == reference_product(left, right));
+  }
+
+  for (const size_t digits : { 1800, 2707, 5000 }) {
+    const std::string text = random_digits(generator, digits);
+    Bigint number = -Bigint(text);
+
+    EXPECT_TRUE(number.square() == reference_product(Bigint(text), text));
+  }
+
+  const Bigint nines(std::string(3000, '9'));
+  EXPECT_TRUE(nines * nines == reference_product(nines, std::string(3000, '9')));
+}
+
+TEST(NttTests, NttTests) {
+  std::mt19937 generator(20203);
+  const std::array<std::pair<size_t, size_t>, 4> sizes = { {
+    { 7300, 7300 },
+    { 14000, 13600 },
+    { 36865, 36863 },
+    { 60000, 14000 },
+  } };
+
+  for (const auto &[left_digits, right_digits] : sizes) {
+    const std::string right = random_digits(generator, right_digits);
+    const Bigint left(random_digits(generator, left_digits));
+
+    EXPECT_TRUE(left * Bigint(right) == reference_product(left, right));
+  }
+
+  const Bigint nines(std::string(40000, '9'));
+  EXPECT_TRUE(nines * nines == reference_product(nines, std::string(40000, '9')));
+
+  const Bigint left(random_digits(generator, 1000000));
+  const Bigint right(random_digits(generator, 700000));
+  const Bigint product = left * right;
+
+  for (const int64_t prime : { 999999937, 1000000007, 2147483647 }) {
+    EXPECT_TRUE(product % prime == (left % prime) * (right % prime) % prime);
+  }
+  EXPECT_TRUE((left + 1) * (left - 1) == left * left - 1);
 }
 
 TEST(DivisionTests, DivisionTests) {
@@ -140,6 +483,80 @@ TEST(DivisionTests, DivisionTests) {
   EXPECT_TRUE(a == 205);
 
   EXPECT_THROW(Bigint(123) / 0, std::invalid_argument);
+
+  const Bigint dividend("-23472331074189168931468914618941490718913");
+  EXPECT_TRUE(dividend / Bigint(2) == Bigint("-11736165537094584465734457309470745359456"));
+  EXPECT_TRUE(dividend.is_negative());
+}
+
+TEST(LongDivisionTests, LongDivisionTests) {
+  std::mt19937 generator(20205);
+  const std::array<std::pair<size_t, size_t>, 6> sizes = { {
+    { 20000, 10000 },
+    { 20000, 19990 },
+    { 3000, 10 },
+    { 3000, 19 },
+    { 1000, 999 },
+    { 500, 120 },
+  } };
+
+  for (const auto &[left_digits, right_digits] : sizes) {
+    const Bigint left(random_digits(generator, left_digits));
+    const Bigint right(random_digits(generator, right_digits));
+    const Bigint quotient = left / right;
+    const Bigint remainder = left - quotient * right;
+
+    EXPECT_TRUE(remainder >= Bigint(0));
+    EXPECT_TRUE(remainder < right);
+  }
+
+  // Divisors with a small top limb need the largest normalization and exercise the add-back step.
+  const Bigint power = Bigint(1).add_zeroes(900);
+  const Bigint divisor = Bigint(1).add_zeroes(450) + 1;
+
+  EXPECT_TRUE(power / divisor == Bigint(1).add_zeroes(450) - 1);
+  EXPECT_TRUE((power - 1) / (power - 1) == Bigint(1));
+  EXPECT_TRUE(power / (power - 1) == Bigint(1));
+  EXPECT_TRUE((power - 1) / power == Bigint(0));
+  EXPECT_TRUE(Bigint(std::string(1800, '9')) / Bigint(std::string(900, '9')) == power + 1);
+
+  const Bigint left(random_digits(generator, 5000));
+  const Bigint right(random_digits(generator, 2000));
+  EXPECT_TRUE((left * right + right - 1) / right == left);
+  EXPECT_TRUE(-(left * right) / right == left * -1);
+}
+
+TEST(RecursiveDivisionTests, RecursiveDivisionTests) {
+  std::mt19937 generator(20206);
+  const std::array<std::pair<size_t, size_t>, 6> sizes = { {
+    { 2000, 1000 },
+    { 20000, 10000 },
+    { 60000, 4600 },
+    { 9000, 8200 },
+    { 100000, 50000 },
+    { 40000, 13337 },
+  } };
+
+  for (const auto &[left_digits, right_digits] : sizes) {
+    const Bigint left(random_digits(generator, left_digits));
+    const Bigint right(random_digits(generator, right_digits));
+    const Bigint quotient = left / right;
+    const Bigint remainder = left - quotient * right;
+
+    EXPECT_TRUE(remainder >= Bigint(0));
+    EXPECT_TRUE(remainder < right);
+  }
+
+  // Equal top halves force the saturated quotient estimate in the 3n/2n step.
+  const Bigint power = Bigint(1).add_zeroes(9000);
+  EXPECT_TRUE(Bigint(std::string(18000, '9')) / Bigint(std::string(9000, '9')) == power + 1);
+  EXPECT_TRUE((power * power - 1) / (power - 1) == power + 1);
+  EXPECT_TRUE((power * power) / (power + 1) == power - 1);
+
+  const Bigint left(random_digits(generator, 30000));
+  const Bigint right(random_digits(generator, 25000));
+  EXPECT_TRUE((left * right + right - 1) / right == left);
+  EXPECT_TRUE((left * right) / left == right);
 }
 
 TEST(AllocationTests, AllocationTests) {
@@ -168,11 +585,443 @@ TEST(PowerTests, PowerTests) {
   EXPECT_TRUE(Bigint(3).pow(7) == Bigint(2187));
   EXPECT_TRUE(Bigint(-2).pow(11) == Bigint(-2048));
   EXPECT_TRUE(Bigint(-2).pow(8) == Bigint(256));
+  EXPECT_TRUE(Bigint(0).pow(5) == Bigint(0));
+  EXPECT_TRUE(Bigint(-1).pow(10000000001ULL) == Bigint(-1));
+  EXPECT_TRUE(Bigint(1).pow(UINT64_MAX) == Bigint(1));
+  EXPECT_TRUE(Bigint(10).pow(100) == Bigint(1).add_zeroes(100));
+
+  std::mt19937 generator(18);
+  const Bigint base = -Bigint(random_digits(generator, 40));
+  Bigint expected = 1;
+  for (uint64_t power = 1; power <= 300; ++power) {
+    expected *= base;
+    EXPECT_TRUE(base.clone().pow(power) == expected);
+  }
+}
+
+TEST(SquareTests, SquareTests) {
+  EXPECT_TRUE(Bigint().square() == Bigint(0));
+  EXPECT_TRUE(Bigint(-12).square() == Bigint(144));
+  EXPECT_TRUE(Bigint(999999999).square() == Bigint("999999998000000001"));
+
+  std::mt19937 generator(17);
+
+  for (const size_t digits : { 300, 600, 1300, 2000, 9000 }) {
+    const std::string text = random_digits(generator, digits);
+    Bigint number = -Bigint(text);
+
+    EXPECT_TRUE(number.square() == reference_product(Bigint(text), text));
+    EXPECT_TRUE(Bigint(text).square() == Bigint(text) * Bigint(text));
+  }
+}
+
+TEST(ModContextTests, ModContextTests) {
+  EXPECT_THROW(ModContext(Bigint(0)), std::invalid_argument);
+  EXPECT_THROW(ModContext(Bigint(-7)), std::invalid_argument);
+
+  const ModContext small(Bigint(97));
+  EXPECT_TRUE(small.is_montgomery());
+  EXPECT_THROW(static_cast<void>(small.mulmod(Bigint(97), Bigint(1))), std::invalid_argument);
+  EXPECT_THROW(static_cast<void>(small.powmod(small.to_residue(2), Bigint(-1))), std::invalid_argument);
+  EXPECT_TRUE(small.from_residue(small.to_residue(Bigint(-1))) == Bigint(96));
+  EXPECT_TRUE(small.from_residue(small.powmod(small.to_residue(5), Bigint(0))) == Bigint(1));
+
+  std::mt19937 generator(19);
+  for (const char *modulus : { "1", "6", "1000000007", "1000000000000000000000000000000", "18446744073709551616",
+         "123456789123456789123456789123456789123456789123456789123456789123456789123456789" }) {
+    const ModContext context{ Bigint(modulus) };
+    const Bigint &m = context.modulus();
+
+    for (int32_t round = 0; round < 20; ++round) {
+      Bigint a = Bigint(random_digits(generator, 1 + generator() % 170));
+      const Bigint b = -Bigint(random_digits(generator, 1 + generator() % 90));
+      const Bigint a_residue = context.to_residue(a);
+      const Bigint b_residue = context.to_residue(b);
+
+      const Bigint expected_product = ((a % m) * (b % m) % m + m) % m;
+      EXPECT_TRUE(context.from_residue(context.mulmod(a_residue, b_residue)) == expected_product);
+      EXPECT_TRUE(context.from_residue(context.sqrmod(b_residue)) == b * b % m);
+
+      Bigint expected_power = Bigint(1) % m;
+      const uint32_t exponent = generator() % 40;
+      for (uint32_t i = 0; i < exponent; ++i) {
+        expected_power = expected_power * a % m;
+      }
+      EXPECT_TRUE(context.from_residue(context.powmod(a_residue, exponent)) == expected_power);
+    }
+  }
+
+  const ModContext barrett{ Bigint(1).add_zeroes(30) };
+  EXPECT_FALSE(barrett.is_montgomery());
+  EXPECT_TRUE(barrett.powmod(Bigint(7), 1000) == Bigint(7).pow(1000) % barrett.modulus());
+
+  const ModContext mersenne{ Bigint(2).pow(521) - 1 };
+  EXPECT_TRUE(mersenne.is_montgomery());
+  const Bigint power = mersenne.powmod(mersenne.to_residue(3), Bigint(10).pow(40) + 7);
+  EXPECT_TRUE(mersenne.from_residue(power) == Bigint("2940799015610611506619277061529328418569870105144398694739791495664842484290507612852066053775931476354973592556921247408606086867423052216755357871500368621"));
+
+  const ModContext context{ Bigint(
+    "5380279890599786745722465496835548693970636342438275628623079328560458179388958258646146634552476780086060276095133786820929396883977987996308400151052157626527503215715763506390118900061656225247795115879879384575945533126446063472553693256070944181948194757600259053289464759612545371051898269064366699247023497232372721390127191603493830815445648054640379737540243287085928196058131952307427603294101852591553298634845694993035317943821393111972785167966178292152374611229116928533979861449969993895054523005128127179141119613796101727579962130280719528014271671908924868835976805463595135301265685275156285914181") };
+  const Bigint base(
+    "90443233555598361643000147574812143967814760642795675162682849020696784324831794541573627194213009584025687124813105797676735295248250215326404956617029137949887423839393238894488912380507472003934714799934703944820292959860922084686161842604302716530333458079741938329638341216953869531552016233948905414871875119861972965791271938256097492643717948372399026629009225226421621635065255441764511661197609260909217535032875216939902026640671588058075885989622649155253329453890282322104576375049282813858432561018345335433347064533747799335830934971897550544300339402300931318753309342171736043070416733");
+  const Bigint exponent("368868502809022476235616230372102770635519227846991186648816427255469561877062216542864137");
+  EXPECT_FALSE(context.is_montgomery());
+  EXPECT_TRUE(context.from_residue(context.powmod(context.to_residue(base), exponent)) == Bigint(
+    "5291260584864213041985962531087958385892965530468235582217965282657631161732819356949963206096841908357532336450094020727401046939487616650371408068931431914359572393633367574687228568687035364497555130464785948377979566561760674878499042914526075184052493987411874211563812589457525998164531631468785403090049912890792153035759012973384076917489428677390268987237978753249502367053523791683683435529456792123818878417251149895756511111872531560338518401517036074778169832241371129261668849279126483861264842706285828279763983266979276844902221100719826949391603922914325261870611307295016641009765058314070781701581"));
 }
 
 TEST(Modulo, Modulo) {
   EXPECT_TRUE(Bigint("239847892391") % 13 == 3);
   EXPECT_TRUE(Bigint("-239847892391") % 13 == -3);
+
+  EXPECT_TRUE(Bigint(1411) % Bigint(123) == Bigint(58));
+  EXPECT_TRUE(Bigint(-1411) % Bigint(123) == Bigint(-58));
+  EXPECT_TRUE(Bigint(1411) % Bigint(-123) == Bigint(58));
+  EXPECT_TRUE(Bigint(141) % Bigint(1323) == Bigint(141));
+  EXPECT_TRUE(Bigint(1323) % Bigint(147) == Bigint(0));
+  EXPECT_THROW(Bigint(123) % Bigint(0), std::invalid_argument);
+
+  Bigint a("23472331074189168931468914618941490718913");
+  a %= Bigint("942394729842789");
+
+  EXPECT_TRUE(a == Bigint("793377858527144"));
+
+  std::mt19937 generator(7);
+  for (const auto &[left_digits, right_digits] : std::array<std::pair<size_t, size_t>, 3>{ { { 40, 17 }, { 3000, 1200 }, { 9000, 8995 } } }) {
+    const Bigint left(random_digits(generator, left_digits));
+    const Bigint right(random_digits(generator, right_digits));
+    const auto [quotient, remainder] = divmod(left, right);
+
+    EXPECT_TRUE(quotient == left / right);
+    EXPECT_TRUE(remainder == left % right);
+    EXPECT_TRUE(remainder < right);
+    EXPECT_TRUE(quotient * right + remainder == left);
+  }
+
+  const Bigint wide("123456789012345678901234567890");
+  EXPECT_TRUE(wide % INT64_MAX == 4860475750367701695);
+  EXPECT_TRUE(wide % INT64_MIN == 4860475736982489810);
+  EXPECT_TRUE(Bigint("-123456789012345678901234567890") % 9999999967 == -6419745024);
+  EXPECT_THROW(static_cast<void>(wide % 0), std::invalid_argument);
+}
+
+TEST(RemaindersTests, RemaindersTests) {
+  EXPECT_TRUE(remainders(Bigint(12345), {}).empty());
+  EXPECT_THROW(remainders(Bigint(12345), { 3, 0 }), std::invalid_argument);
+
+  std::mt19937_64 generator(20);
+  std::vector<int64_t> moduli = { 1, -1, 2, INT64_MAX, INT64_MIN, 1000000000, -999999937 };
+  while (moduli.size() < 1000) {
+    moduli.push_back(static_cast<int64_t>(generator() >> (generator() % 63)) | 1);
+  }
+
+  std::mt19937 digits(20);
+  for (const Bigint &value : { Bigint(), Bigint(987654321), Bigint(random_digits(digits, 6000)), -Bigint(random_digits(digits, 30000)) }) {
+    const std::vector<int64_t> result = remainders(value, moduli);
+
+    ASSERT_EQ(result.size(), moduli.size());
+    for (size_t i = 0; i < moduli.size(); ++i) {
+      EXPECT_TRUE(Bigint(result[i]) == value % Bigint(moduli[i]));
+    }
+  }
+}
+
+TEST(GcdTests, GcdTests) {
+  EXPECT_TRUE(gcd(Bigint(0), Bigint(0)) == Bigint(0));
+  EXPECT_TRUE(gcd(Bigint(0), Bigint(-15)) == Bigint(15));
+  EXPECT_TRUE(gcd(Bigint(-84), Bigint(36)) == Bigint(12));
+  EXPECT_TRUE(gcd(Bigint("1000000000000000000000000000"), Bigint("250000000000000000000")) == Bigint("250000000000000000000"));
+  EXPECT_TRUE(lcm(Bigint(-4), Bigint(6)) == Bigint(12));
+  EXPECT_TRUE(lcm(Bigint(0), Bigint(6)) == Bigint(0));
+
+  const auto [g, x, y] = extended_gcd(Bigint(240), Bigint(-46));
+  EXPECT_TRUE(g == Bigint(2) && x == Bigint(14) && y == Bigint(73));
+
+  EXPECT_TRUE(mod_inverse(Bigint(3), Bigint(11)) == Bigint(4));
+  EXPECT_TRUE(mod_inverse(Bigint(-3), Bigint(11)) == Bigint(7));
+  EXPECT_TRUE(mod_inverse(Bigint(5), Bigint(1)) == Bigint(0));
+  EXPECT_THROW(mod_inverse(Bigint(6), Bigint(9)), std::invalid_argument);
+  EXPECT_THROW(mod_inverse(Bigint(6), Bigint(0)), std::invalid_argument);
+
+  // g divides both and is a combination of them, so it is their gcd
+  std::mt19937 generator(21);
+  for (const size_t digits : { 12, 40, 300, 2000, 6000, 20000 }) {
+    const Bigint common(random_digits(generator, 1 + digits / 4));
+    const Bigint left = common * Bigint(random_digits(generator, digits));
+    const Bigint right = -(common * Bigint(random_digits(generator, digits - digits / 5)));
+
+    const auto [divisor, left_cofactor, right_cofactor] = extended_gcd(left, right);
+    EXPECT_TRUE(left % divisor == Bigint(0) && right % divisor == Bigint(0));
+    EXPECT_TRUE(left * left_cofactor + right * right_cofactor == divisor);
+    EXPECT_TRUE(gcd(right, left) == divisor);
+    EXPECT_TRUE(divisor % common == Bigint(0));
+
+    Bigint modulus = right / divisor;
+    const Bigint inverse = mod_inverse(left / divisor, modulus.abs());
+    EXPECT_TRUE(inverse < modulus && left / divisor * inverse % modulus == Bigint(1));
+  }
+}
+
+TEST(RootTests, RootTests) {
+  EXPECT_TRUE(isqrt(Bigint(0)) == Bigint(0));
+  EXPECT_TRUE(isqrt(Bigint(15)) == Bigint(3));
+  EXPECT_TRUE(isqrt(Bigint(16)) == Bigint(4));
+  EXPECT_TRUE(iroot(Bigint(-27), 3) == Bigint(-3));
+  EXPECT_TRUE(iroot(Bigint(-26), 3) == Bigint(-2));
+  EXPECT_TRUE(iroot(Bigint("1000000000000000000000000000000"), 100) == Bigint(1));
+  EXPECT_TRUE(iroot(Bigint(12345), 1) == Bigint(12345));
+  EXPECT_THROW(isqrt(Bigint(-4)), std::invalid_argument);
+  EXPECT_THROW(iroot(Bigint(8), 0), std::invalid_argument);
+
+  // root^k <= n < (root + 1)^k, checked on both sides of exact powers
+  std::mt19937 generator(22);
+  for (const size_t digits : { 10, 40, 400, 4000 }) {
+    for (const uint64_t k : { 2, 3, 5, 7, 100 }) {
+      const Bigint base(random_digits(generator, digits / k + 1));
+      Bigint power(base);
+      power.pow(k);
+      EXPECT_TRUE(iroot(power, k) == base);
+      EXPECT_TRUE(iroot(power - 1, k) == base - 1);
+      EXPECT_TRUE(iroot(power + 1, k) == base);
+    }
+  }
+
+  EXPECT_TRUE(is_perfect_square(Bigint(0)));
+  EXPECT_TRUE(is_perfect_square(Bigint(1)));
+  EXPECT_TRUE(is_perfect_square(Bigint(3).pow(100)));
+  EXPECT_FALSE(is_perfect_square(Bigint(3).pow(101)));
+  EXPECT_FALSE(is_perfect_square(Bigint(-4)));
+  const Bigint square = Bigint(random_digits(generator, 3000)).square();
+  EXPECT_TRUE(is_perfect_square(square));
+  EXPECT_FALSE(is_perfect_square(square + 1));
+  EXPECT_FALSE(is_perfect_square(square - 1));
+
+  EXPECT_TRUE(is_perfect_power(Bigint(0)));
+  EXPECT_TRUE(is_perfect_power(Bigint(-1)));
+  EXPECT_TRUE(is_perfect_power(Bigint(-27)));
+  EXPECT_FALSE(is_perfect_power(Bigint(-4)));
+  EXPECT_TRUE(is_perfect_power(Bigint(6).pow(7)));
+  EXPECT_TRUE(is_perfect_power(Bigint(2).pow(127)));
+  EXPECT_FALSE(is_perfect_power(Bigint(2).pow(127) - 1));
+  EXPECT_TRUE(is_perfect_power(Bigint("123456789123456789").pow(13)));
+  EXPECT_TRUE(is_perfect_power(Bigint(987654321).pow(4)));
+  for (const size_t digits : { 20, 300, 3000 }) {
+    Bigint base(random_digits(generator, digits));
+    EXPECT_FALSE(is_perfect_power(base * base * Bigint(2)));
+    EXPECT_TRUE(is_perfect_power(-(base.pow(3))));
+  }
+}
+
+TEST(BitwiseTests, BitwiseTests) {
+  for (int64_t x = -70; x <= 70; x += 3) {
+    for (int64_t y = -70; y <= 70; y += 5) {
+      EXPECT_TRUE((Bigint(x) & Bigint(y)) == Bigint(x & y));
+      EXPECT_TRUE((Bigint(x) | Bigint(y)) == Bigint(x | y));
+      EXPECT_TRUE((Bigint(x) ^ Bigint(y)) == Bigint(x ^ y));
+    }
+    EXPECT_TRUE(~Bigint(x) == Bigint(~x));
+    EXPECT_TRUE((Bigint(x) >> 3) == Bigint(x >> 3));
+    EXPECT_TRUE((Bigint(x) << 3) == Bigint(x * 8));
+    EXPECT_EQ(Bigint(x).test_bit(2), ((x >> 2) & 1) != 0);
+    EXPECT_EQ(Bigint(x).test_bit(100), x < 0);
+  }
+  EXPECT_TRUE((Bigint(INT64_MIN) & Bigint(-1)) == Bigint(INT64_MIN));
+  EXPECT_TRUE((Bigint(1) << 100) == Bigint("1267650600228229401496703205376"));
+  EXPECT_TRUE((Bigint("1267650600228229401496703205377") >> 100) == Bigint(1));
+  EXPECT_TRUE((Bigint(-5) >> 1000) == Bigint(-1));
+
+  EXPECT_EQ(Bigint(0).bit_length(), 0U);
+  EXPECT_EQ(Bigint(0).count_trailing_zeros(), 0U);
+  EXPECT_EQ(Bigint(-255).popcount(), 8U);
+  for (const uint64_t bits : { 1, 31, 32, 64, 65, 1000, 30000 }) {
+    const Bigint power = Bigint(1) << bits;
+    EXPECT_EQ(power.bit_length(), bits + 1);
+    EXPECT_EQ((power - 1).bit_length(), bits);
+    EXPECT_EQ((power - 1).popcount(), bits);
+    EXPECT_EQ((power * 3).count_trailing_zeros(), bits);
+    EXPECT_EQ((power * Bigint("-1000000000000000000000")).count_trailing_zeros(), bits + 21);
+    EXPECT_TRUE(power.test_bit(bits) && !power.test_bit(bits - 1));
+    EXPECT_TRUE((Bigint(0) - power).test_bit(bits) && !(Bigint(0) - power).test_bit(bits - 1));
+    EXPECT_TRUE(!(Bigint(0) - power * 3).test_bit(bits + 1) && (Bigint(0) - power * 3).test_bit(bits + 2));
+  }
+
+  // Identities on numbers large enough to go through the split conversions
+  std::mt19937 generator(23);
+  for (const size_t digits : { 30, 400, 5000, 30000 }) {
+    Bigint left(random_digits(generator, digits));
+    Bigint right(random_digits(generator, digits - digits / 3));
+    for (int sign = 0; sign < 4; ++sign) {
+      const Bigint a = sign % 2 == 0 ? left : Bigint(0) - left;
+      const Bigint b = sign / 2 == 0 ? right : Bigint(0) - right;
+      EXPECT_TRUE((a & b) + (a | b) == a + b);
+      for (const uint64_t index : { uint64_t{ 0 }, uint64_t{ 37 }, a.bit_length() / 2, a.bit_length() - 1, a.bit_length() + 3 }) {
+        EXPECT_EQ(a.test_bit(index), !(a >> index).is_even());
+      }
+      EXPECT_TRUE((a ^ b) == (a | b) - (a & b));
+      EXPECT_TRUE((a & ~b) == (a ^ (a & b)));
+      EXPECT_TRUE(((a << 777) >> 777) == a);
+      EXPECT_TRUE((a & Bigint(65535)) == (a % Bigint(65536) + Bigint(65536)) % Bigint(65536));
+      EXPECT_TRUE((a >> 100) == (a - (a & ((Bigint(1) << 100) - 1))) / (Bigint(1) << 100));
+    }
+    EXPECT_EQ((left ^ right).popcount() + 2 * (left & right).popcount(), left.popcount() + right.popcount());
+  }
+}
+
+TEST(MultiplyTests, MultiplyTests) {
+  EXPECT_TRUE(multiply(Bigint(-12), Bigint(11), 4) == Bigint(-132));
+  EXPECT_TRUE(multiply(Bigint(0), Bigint(-11), 0) == Bigint(0));
+  EXPECT_TRUE(BigMath::multiply(Bigint("-123456789123456789"), Bigint(1000000007), 2) == Bigint("-123456789987654312864197523"));
+
+  // Large enough for the transforms and the recombination to be split between threads
+  std::mt19937 generator(24);
+  const Bigint left(random_digits(generator, 200000));
+  const Bigint right(random_digits(generator, 190000));
+  const Bigint expected = left * right;
+  for (const size_t threads : { 1, 2, 3, 4, 8 }) {
+    EXPECT_TRUE(multiply(left, right, threads) == expected);
+  }
+  EXPECT_TRUE(multiply(left, left, 4) == Bigint(left).square());
+}
+
+// The scalar add_n and sub_n and every vector kernel this CPU can run, against a plain carry loop. Dispatch
+// picks one kernel per process, so each is called here directly.
+TEST(LimbKernelTests, LimbKernelTests) {
+  using BigMath::Limb;
+  using Kernel = uint32_t (*)(Limb *, const Limb *, size_t, uint32_t);
+  std::vector<std::pair<Kernel, Kernel>> kernels = { { BigMath::limbs::add_n, BigMath::limbs::sub_n } };
+#ifdef BIGINT_X86_KERNELS
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    kernels.emplace_back(BigMath::limbs::add_n_avx2, BigMath::limbs::sub_n_avx2);
+  }
+  if (__builtin_cpu_supports("avx512f")) {
+    kernels.emplace_back(BigMath::limbs::add_n_avx512, BigMath::limbs::sub_n_avx512);
+  }
+#endif
+
+  constexpr auto top = static_cast<Limb>(BigMath::limbs::BASE - 1);
+  std::mt19937 generator(16);
+  std::uniform_int_distribution<Limb> limb(0, top);
+  // Lengths around the 8 and 16 limb vector blocks, so every tail length is met
+  for (size_t size = 0; size <= 70; ++size) {
+    for (int pattern = 0; pattern < 4; ++pattern) {
+      std::vector<Limb> left(size);
+      std::vector<Limb> right(size);
+      for (size_t idx = 0; idx < size; ++idx) {
+        left[idx] = pattern == 1 ? top : pattern == 2 ? 0 : limb(generator);
+        right[idx] = pattern == 1 ? (idx == 0 ? 1 : 0) : pattern == 2 ? (idx % 9 == 0 ? 1 : 0) : limb(generator);
+        if (pattern == 3 && idx % 5 == 0) {// carries and borrows crossing lanes at random places
+          left[idx] = idx % 10 == 0 ? top : 0;
+          right[idx] = idx % 10 == 0 ? top : 0;
+        }
+      }
+
+      for (uint32_t carry = 0; carry <= 1; ++carry) {
+        std::vector<Limb> expected_sum(size);
+        std::vector<Limb> expected_difference(size);
+        int64_t sum_carry = carry;
+        int64_t difference_borrow = carry;
+        for (size_t idx = 0; idx < size; ++idx) {
+          const int64_t sum = int64_t{ left[idx] } + right[idx] + sum_carry;
+          const int64_t difference = int64_t{ left[idx] } - right[idx] - difference_borrow;
+          sum_carry = sum > top ? 1 : 0;
+          difference_borrow = difference < 0 ? 1 : 0;
+          expected_sum[idx] = static_cast<Limb>(sum - sum_carry * (int64_t{ top } + 1));
+          expected_difference[idx] = static_cast<Limb>(difference + difference_borrow * (int64_t{ top } + 1));
+        }
+
+        for (const auto &[add, sub] : kernels) {
+          std::vector<Limb> sum(left);
+          std::vector<Limb> difference(left);
+
+          EXPECT_EQ(add(sum.data(), right.data(), size, carry), static_cast<uint32_t>(sum_carry));
+          EXPECT_EQ(sub(difference.data(), right.data(), size, carry), static_cast<uint32_t>(difference_borrow));
+          EXPECT_TRUE(sum == expected_sum);
+          EXPECT_TRUE(difference == expected_difference);
+        }
+      }
+    }
+  }
+}
+
+TEST(ThreadTeamTests, ThreadTeamTests) {
+  std::vector<size_t> visits(4);
+  BigMath::limbs::run_team(4, [&](const BigMath::limbs::Share &share) {
+    for (size_t phase = 0; phase < 3; ++phase) {
+      ++visits[share.index];
+      share.sync();
+    }
+  });
+
+  EXPECT_TRUE(visits == std::vector<size_t>(4, 3));
+
+  // A member that throws never reaches the barrier again, the others have to be released instead of hanging.
+  for (const size_t failing : { 0, 2 }) {
+    EXPECT_THROW(BigMath::limbs::run_team(4, [failing](const BigMath::limbs::Share &share) {
+      share.sync();
+      if (share.index == failing) {
+        throw std::bad_alloc();
+      }
+      share.sync();
+      share.sync();
+    }), std::bad_alloc);
+  }
+}
+
+TEST(ProductTests, ProductTests) {
+  EXPECT_TRUE(product({}) == Bigint(1));
+  EXPECT_TRUE(product({ Bigint(-3), Bigint(7), Bigint(-2) }) == Bigint(42));
+  EXPECT_TRUE(product_range(5, 4) == Bigint(1));
+  EXPECT_TRUE(product_range(0, 9) == Bigint(0));
+  EXPECT_TRUE(product_range(10, 12) == Bigint(1320));
+  EXPECT_TRUE(product_range(18446744073709551614ULL, 18446744073709551615ULL) == Bigint("340282366920938463408034375210639556610"));
+  EXPECT_TRUE(factorial(0) == Bigint(1));
+  EXPECT_TRUE(factorial(25) == Bigint("15511210043330985984000000"));
+  EXPECT_TRUE(binomial(5, 7) == Bigint(0));
+  EXPECT_TRUE(binomial(100, 50) == Bigint("100891344545564193334812497256"));
+
+  Bigint expected(1);
+  for (int64_t n = 1; n <= 3000; ++n) {
+    expected *= n;
+    if (n % 250 == 0 || n == 64 || n == 127 || n == 128) {
+      EXPECT_TRUE(factorial(static_cast<uint64_t>(n)) == expected);
+      EXPECT_TRUE(factorial(static_cast<uint64_t>(n), 4) == expected);
+    }
+  }
+
+  // Pascal's triangle, through both the range quotient and the prime factorization
+  std::vector<Bigint> row{ Bigint(1) };
+  for (uint64_t n = 1; n <= 200; ++n) {
+    std::vector<Bigint> next(n + 1, Bigint(1));
+    for (uint64_t k = 1; k < n; ++k) {
+      next[k] = row[k - 1] + row[k];
+    }
+    row = std::move(next);
+  }
+  for (uint64_t k = 0; k <= 200; ++k) {
+    EXPECT_TRUE(binomial(200, k) == row[k]);
+  }
+
+  std::mt19937 generator(25);
+  std::vector<Bigint> factors;
+  Bigint folded(1);
+  for (size_t idx = 0; idx < 300; ++idx) {
+    Bigint factor(random_digits(generator, 1 + idx % 40));
+    if (idx % 7 == 0) {
+      factor = Bigint(0) - factor;
+    }
+    folded *= factor;
+    factors.push_back(std::move(factor));
+  }
+  EXPECT_TRUE(product(factors) == folded);
+  EXPECT_TRUE(product(factors, 3) == folded);
+  EXPECT_TRUE(product_range(1000, 5000, 4) == factorial(5000) / factorial(999));
+
+  // 0 threads means one per core, as for multiply()
+  EXPECT_TRUE(product(factors, 0) == folded);
+  EXPECT_TRUE(product_range(1000, 5000, 0) == product_range(1000, 5000));
+  EXPECT_TRUE(factorial(3000, 0) == expected);
+  EXPECT_TRUE(binomial(200, 77, 0) == row[77]);
 }
 
 TEST(IsEven, IsEven) {
@@ -187,6 +1036,105 @@ TEST(ABS, ABS) {
   EXPECT_TRUE(Bigint("239847892391").abs() == Bigint("239847892391"));
 }
 
+TEST(SmallVectorTests, SmallVectorTests) {
+  BigMath::SmallVector<int32_t, 4> small;
+  for (int32_t idx = 0; idx < 4; ++idx) {
+    small.push_back(idx);
+  }
+
+  EXPECT_TRUE(small.capacity() == 4);
+
+  BigMath::SmallVector<int32_t, 4> large(small);
+  large.push_back(4);
+
+  EXPECT_TRUE(large.capacity() > 4);
+
+  BigMath::SmallVector<int32_t, 4> moved(std::move(small));
+  large.swap(moved);
+
+  EXPECT_TRUE(moved.size() == 5 && moved[4] == 4);
+  EXPECT_TRUE(large.size() == 4 && large[3] == 3);
+
+  moved = std::move(large);
+
+  EXPECT_TRUE(moved.size() == 4 && moved[0] == 0 && moved[3] == 3);
+
+  // Moving into a vector of another resource copies, and an allocation failure there has to reach the caller.
+  static_assert(std::is_nothrow_move_constructible_v<BigMath::SmallVector<int32_t, 4>>);
+  static_assert(!std::is_nothrow_move_assignable_v<BigMath::SmallVector<int32_t, 4>>);
+  BigMath::SmallVector<int32_t, 4> foreign(std::pmr::null_memory_resource());
+  BigMath::SmallVector<int32_t, 4> source(int32_t{ 9 }, 10);
+
+  EXPECT_THROW(foreign = std::move(source), std::bad_alloc);
+  EXPECT_THROW(foreign.swap(source), std::bad_alloc);
+
+  std::array<std::byte, 256> buffer;
+  std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+  BigMath::SmallVector<int32_t, 4> bounded(int32_t{ 5 }, 8, &arena);
+  BigMath::SmallVector<int32_t, 4> wide(int32_t{ 6 }, 1000);
+
+  EXPECT_THROW(bounded = std::move(wide), std::bad_alloc);
+  EXPECT_TRUE(bounded.size() == 8 && bounded[7] == 5);
+
+  BigMath::SmallVector<int32_t, 4> grown;
+  for (size_t size = 1; size <= 1000; ++size) {
+    grown.resize(size, static_cast<int32_t>(size));
+  }
+
+  EXPECT_TRUE(grown.capacity() < 2000 && grown[999] == 1000);
+
+  BigMath::SmallVector<int32_t, 4> copy(grown);
+
+  EXPECT_TRUE(copy.capacity() == 1000 && copy[0] == 1);
+
+  grown.resize(2000);
+  grown.shrink_to_fit();
+
+  EXPECT_TRUE(grown.capacity() == 2000 && grown[1999] == 0);
+
+  copy.clear();
+  copy.push_back(7);
+  copy.shrink_to_fit();
+
+  EXPECT_TRUE(copy.capacity() == 4 && copy.back() == 7);
+
+  Bigint a("123456789012345678901234567890");
+  Bigint b = std::move(a);
+  Bigint c = b;
+
+  EXPECT_TRUE(c == Bigint("123456789012345678901234567890"));
+}
+
+TEST(AllocatorTests, AllocatorTests) {
+  std::array<std::byte, 1 << 16> buffer;
+  std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+  const Bigint::allocator_type allocator(&arena);
+
+  Bigint a("123456789012345678901234567890123456789012345678901234567890", allocator);
+  Bigint b = a * a;
+  b += a;
+  auto [quotient, remainder] = divmod(b, Bigint(7));
+
+  EXPECT_TRUE(b.get_allocator() == allocator);
+  EXPECT_TRUE(quotient.get_allocator() == allocator);
+  EXPECT_TRUE(remainder.get_allocator() == allocator);
+  EXPECT_TRUE(quotient * 7 + remainder == b);
+
+  Bigint c(b, Bigint::allocator_type());
+  c = a;
+
+  EXPECT_TRUE(c.get_allocator() == Bigint::allocator_type());
+  EXPECT_TRUE(c == a);
+
+  std::pmr::vector<Bigint> values(allocator);
+  values.emplace_back("98765432109876543210987654321098765432109876543210");
+  values.push_back(c);
+
+  EXPECT_TRUE(values[0].get_allocator() == allocator);
+  EXPECT_TRUE(values[1].get_allocator() == allocator);
+  EXPECT_TRUE(values[1] == a);
+}
+
 TEST(Clone, Clone) {
   Bigint a(123);
   Bigint b = a.clone();
@@ -211,6 +1159,38 @@ TEST(Streams, Streams) {
   EXPECT_NO_THROW(stream >> b);
 
   EXPECT_TRUE(b == Bigint("2343239041089250841095749017409275918212719"));
+
+  EXPECT_TRUE(Bigint("-1000000000000000000000000001").to_string() == "-1000000000000000000000000001");
+  EXPECT_TRUE(Bigint("900000000090000000009").to_string() == "900000000090000000009");
+
+  std::ostringstream output;
+  output << Bigint("-123456789012345678901234567890");
+
+  EXPECT_TRUE(output.str() == "-123456789012345678901234567890");
+
+  std::mt19937 generator(8);
+  const std::string digits = random_digits(generator, 100000);
+
+  EXPECT_TRUE(Bigint(digits).to_string() == digits);
+}
+
+TEST(Parsing, Parsing) {
+  EXPECT_TRUE(Bigint("+123456789012345678901").to_string() == "123456789012345678901");
+  EXPECT_TRUE(Bigint("-000000000000000000000123456789012").to_string() == "-123456789012");
+  EXPECT_TRUE(Bigint(" \t 42\n").to_string() == "42");
+  EXPECT_TRUE(Bigint("1000000000") == Bigint(1000000000));
+  EXPECT_TRUE(Bigint("-0") == Bigint());
+  EXPECT_FALSE(Bigint("-0000000000000").is_negative());
+  EXPECT_TRUE(Bigint("0000000000000").to_string() == "0");
+
+  EXPECT_THROW(Bigint(""), std::invalid_argument);
+  EXPECT_THROW(Bigint("   "), std::invalid_argument);
+  EXPECT_THROW(Bigint("-"), std::invalid_argument);
+  EXPECT_THROW(Bigint("+-1"), std::invalid_argument);
+  EXPECT_THROW(Bigint("12 34"), std::invalid_argument);
+  EXPECT_THROW(Bigint("1234567890123456789O"), std::invalid_argument);
+  EXPECT_THROW(Bigint("12345678901234567:9"), std::invalid_argument);
+  EXPECT_THROW(Bigint("0x1F"), std::invalid_argument);
 }
 
 TEST(Access, Access) {